@@ -0,0 +1,125 @@
+#include "base/AsyncLogging.h"
+#include "base/LogFile.h"
+#include <chrono>
+#include <cstdio>
+
+AsyncLogging::AsyncLogging(std::string basename, off_t roll_size, int flush_interval,
+                           size_t max_buffers, OverflowPolicy policy)
+    : flush_interval_(flush_interval), max_buffers_(max_buffers > 0 ? max_buffers : 1), policy_(policy),
+      basename_(std::move(basename)), roll_size_(roll_size), running_(false), dropped_(0),
+      current_(new Buffer), next_(new Buffer) {
+    buffers_.reserve(max_buffers_);
+}
+
+AsyncLogging::~AsyncLogging() {
+    if (running_) {
+        stop();
+    }
+}
+
+void AsyncLogging::start() {
+    running_ = true;
+    thread_ = std::thread([this] { threadFunc(); });
+}
+
+void AsyncLogging::stop() {
+    running_ = false;
+    cond_.notify_one();
+    space_cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void AsyncLogging::append(const char *logline, size_t len) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (current_->avail() > len) {
+        current_->append(logline, len);
+        return;
+    }
+    if (buffers_.size() >= max_buffers_) {//后台写不过来
+        if (policy_ == DropNewest) {
+            ++dropped_;
+            return;
+        } else if (policy_ == Block) {
+            space_cond_.wait(lock, [this] { return buffers_.size() < max_buffers_ || !running_; });
+        } else {
+            dropped_ += buffers_.front()->lines();
+            buffers_.front()->reset();
+            if (!next_) {//被丢弃的缓冲作为备用
+                next_ = std::move(buffers_.front());
+            }
+            buffers_.erase(buffers_.begin());
+        }
+    }
+    buffers_.push_back(std::move(current_));
+    if (next_) {
+        current_ = std::move(next_);
+    } else {//很少发生，前端写得太快，两块都已写满
+        current_.reset(new Buffer);
+    }
+    current_->append(logline, len);
+    cond_.notify_one();
+}
+
+void AsyncLogging::threadFunc() {
+    LogFile output(basename_, roll_size_, flush_interval_);
+    BufferPtr new_buffer1(new Buffer);
+    BufferPtr new_buffer2(new Buffer);
+    BufferVector buffers_to_write;
+    buffers_to_write.reserve(max_buffers_ + 1);
+    uint64_t reported_dropped = 0;
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (buffers_.empty()) {//没有写满的缓冲时每flush_interval秒写一次当前缓冲
+                cond_.wait_for(lock, std::chrono::seconds(flush_interval_));
+            }
+            buffers_.push_back(std::move(current_));
+            current_ = std::move(new_buffer1);
+            buffers_to_write.swap(buffers_);
+            if (!next_) {
+                next_ = std::move(new_buffer2);
+            }
+        }
+        space_cond_.notify_all();
+
+        uint64_t dropped = dropped_;
+        if (dropped != reported_dropped) {
+            char buf[128];
+            int n = snprintf(buf, sizeof(buf), "AsyncLogging dropped %llu log messages in total\n",
+                             static_cast<unsigned long long>(dropped));
+            output.append(buf, static_cast<size_t>(n));
+            reported_dropped = dropped;
+        }
+        for (const BufferPtr &buffer: buffers_to_write) {
+            output.append(buffer->data(), buffer->length());
+        }
+
+        if (buffers_to_write.size() > 2) {//只保留两块作为备用，其余释放
+            buffers_to_write.resize(2);
+        }
+        if (!new_buffer1) {
+            new_buffer1 = std::move(buffers_to_write.back());
+            buffers_to_write.pop_back();
+            new_buffer1->reset();
+        }
+        if (!new_buffer2 && !buffers_to_write.empty()) {
+            new_buffer2 = std::move(buffers_to_write.back());
+            buffers_to_write.pop_back();
+            new_buffer2->reset();
+        }
+        buffers_to_write.clear();
+        output.flush();
+    }
+    {//写出剩余的日志
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const BufferPtr &buffer: buffers_) {
+            output.append(buffer->data(), buffer->length());
+        }
+        output.append(current_->data(), current_->length());
+        current_->reset();
+        buffers_.clear();
+    }
+    output.flush();
+}
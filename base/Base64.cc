@@ -0,0 +1,82 @@
+#include "base/Base64.h"
+#include <cstdint>
+
+namespace {
+    constexpr char Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    int decodeChar(char c) {
+        if (c >= 'A' && c <= 'Z') {
+            return c - 'A';
+        }
+        if (c >= 'a' && c <= 'z') {
+            return c - 'a' + 26;
+        }
+        if (c >= '0' && c <= '9') {
+            return c - '0' + 52;
+        }
+        if (c == '+') {
+            return 62;
+        }
+        return c == '/' ? 63 : -1;
+    }
+}// namespace
+
+std::string Base64::encode(std::string_view data) {
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        uint32_t n = static_cast<uint8_t>(data[i]) << 16 | static_cast<uint8_t>(data[i + 1]) << 8 |
+                     static_cast<uint8_t>(data[i + 2]);
+        out += Alphabet[n >> 18];
+        out += Alphabet[(n >> 12) & 63];
+        out += Alphabet[(n >> 6) & 63];
+        out += Alphabet[n & 63];
+    }
+    if (i + 1 == data.size()) {
+        uint32_t n = static_cast<uint8_t>(data[i]) << 16;
+        out += Alphabet[n >> 18];
+        out += Alphabet[(n >> 12) & 63];
+        out += "==";
+    } else if (i + 2 == data.size()) {
+        uint32_t n = static_cast<uint8_t>(data[i]) << 16 | static_cast<uint8_t>(data[i + 1]) << 8;
+        out += Alphabet[n >> 18];
+        out += Alphabet[(n >> 12) & 63];
+        out += Alphabet[(n >> 6) & 63];
+        out += '=';
+    }
+    return out;
+}
+
+bool Base64::decode(std::string_view text, std::string *out) {
+    if (text.size() % 4 != 0) {
+        return false;
+    }
+    out->clear();
+    out->reserve(text.size() / 4 * 3);
+    for (size_t i = 0; i < text.size(); i += 4) {
+        int v[4];
+        int padding = 0;
+        for (int j = 0; j < 4; ++j) {
+            char c = text[i + j];
+            if (c == '=' && i + 4 == text.size() && j >= 2) {
+                v[j] = 0;
+                ++padding;
+                continue;
+            }
+            v[j] = decodeChar(c);
+            if (v[j] < 0 || padding > 0) {
+                return false;
+            }
+        }
+        uint32_t n = static_cast<uint32_t>(v[0] << 18 | v[1] << 12 | v[2] << 6 | v[3]);
+        *out += static_cast<char>(n >> 16);
+        if (padding < 2) {
+            *out += static_cast<char>((n >> 8) & 0xFF);
+        }
+        if (padding < 1) {
+            *out += static_cast<char>(n & 0xFF);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+#include "base/BinaryLogging.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Backend {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<std::unique_ptr<BinaryLogging::Ring>> rings;
+        std::thread thread;
+        size_t ring_size = 1024 * 1024;
+        int flush_interval_ms = 100;
+        bool running = false;
+    };
+
+    Backend &backend() {
+        static Backend instance;
+        return instance;
+    }
+
+    uint64_t roundUpPowerOfTwo(uint64_t n) {
+        uint64_t size = 4096;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    //只在后台线程（或stop中join之后）调用，是环唯一的消费者，也只有这里释放环
+    void drainAll(Backend &b) {
+        std::vector<BinaryLogging::Ring *> rings;
+        {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            for (auto &ring: b.rings) {
+                rings.push_back(ring.get());
+            }
+        }
+        bool reclaim = false;
+        for (BinaryLogging::Ring *ring: rings) {
+            bool retired = ring->retired();//先读标记，保证退出前提交的记录都在本次取出
+            ring->consume([](const BinaryLogging::Ring::Header *header) { BinaryLogging::format(header); });
+            reclaim = reclaim || retired;
+        }
+        if (reclaim) {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            b.rings.erase(std::remove_if(b.rings.begin(), b.rings.end(),
+                                         [](const std::unique_ptr<BinaryLogging::Ring> &ring) {
+                                             return ring->retired() && ring->empty();
+                                         }),
+                          b.rings.end());
+        }
+    }
+
+    thread_local bool t_exited = false;
+}// namespace
+
+struct BinaryLogging::ThreadRingOwner {
+    Ring *ring = nullptr;
+
+    ~ThreadRingOwner() {
+        if (ring != nullptr) {
+            t_ring_ = nullptr;
+            t_exited = true;//之后的日志在本线程直接格式化
+            ring->retire();
+        }
+    }
+};
+
+BinaryLogging::Ring::Ring(size_t capacity)
+    : data_(new char[roundUpPowerOfTwo(capacity)]), capacity_(roundUpPowerOfTwo(capacity)), mask_(capacity_ - 1),
+      pending_(0), head_(0), tail_(0), retired_(false) {}
+
+char *BinaryLogging::Ring::reserve(size_t size) {
+    size_t aligned = alignedSize(size);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t offset = head & mask_;
+    uint64_t contiguous = capacity_ - offset;
+    uint64_t padding = contiguous < aligned ? contiguous : 0;//不够放到环尾时从头开始
+    if (aligned > capacity_ / 2 || head + padding + aligned - tail > capacity_) {
+        return nullptr;
+    }
+    if (padding > 0) {
+        auto *pad = reinterpret_cast<Header *>(data_.get() + offset);
+        pad->size = static_cast<uint32_t>(padding);
+        pad->tid = -1;
+        head += padding;
+        offset = 0;
+    }
+    auto *header = reinterpret_cast<Header *>(data_.get() + offset);
+    header->size = static_cast<uint32_t>(size);
+    pending_ = head + aligned;
+    return data_.get() + offset;
+}
+
+void BinaryLogging::start(size_t ring_size, int flush_interval_ms) {
+    Backend &b = backend();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (b.running) {
+        return;
+    }
+    b.ring_size = ring_size;
+    b.flush_interval_ms = flush_interval_ms > 0 ? flush_interval_ms : 1;
+    b.running = true;
+    b.thread = std::thread([&b] {
+        std::unique_lock<std::mutex> lock(b.mutex);
+        while (b.running) {
+            b.cond.wait_for(lock, std::chrono::milliseconds(b.flush_interval_ms));
+            lock.unlock();
+            drainAll(b);
+            lock.lock();
+        }
+    });
+    started_.store(true, std::memory_order_release);
+}
+
+void BinaryLogging::stop() {
+    Backend &b = backend();
+    {
+        std::lock_guard<std::mutex> lock(b.mutex);
+        if (!b.running) {
+            return;
+        }
+        b.running = false;
+    }
+    started_.store(false, std::memory_order_release);
+    b.cond.notify_one();
+    b.thread.join();
+    drainAll(b);
+}
+
+BinaryLogging::Ring *BinaryLogging::registerThread() {
+    if (t_exited) {
+        return nullptr;
+    }
+    Backend &b = backend();
+    static thread_local ThreadRingOwner owner;
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.rings.push_back(std::make_unique<Ring>(b.ring_size));
+    owner.ring = b.rings.back().get();
+    return owner.ring;
+}
+
+const char *BinaryLogging::appendUntilPlaceholder(LogStream &stream, const char *format) {
+    const char *p = strstr(format, "{}");
+    if (p == nullptr) {//参数多于{}时追加在末尾
+        stream << format << ' ';
+        return format + strlen(format);
+    }
+    stream.append(format, static_cast<size_t>(p - format));
+    return p + 2;
+}
+
+void BinaryLogging::format(const Ring::Header *header) {
+    const Site *site = header->site;
+    Logger logger(site->file, site->line, site->level, header->realtime_ns, header->tid);
+    LogStream &stream = logger.stream();
+    const char *format = site->format;
+    const char *p = reinterpret_cast<const char *>(header) + sizeof(Ring::Header);
+    const char *end = reinterpret_cast<const char *>(header) + header->size;
+    while (p < end) {
+        auto type = static_cast<ArgType>(*p++);
+        if (type == String) {
+            auto len = static_cast<uint8_t>(*p++);
+            format = appendUntilPlaceholder(stream, format);
+            stream << std::string_view(p, len);
+            p += len;
+            continue;
+        }
+        if (p + 8 > end) {
+            break;
+        }
+        format = appendUntilPlaceholder(stream, format);
+        if (type == Int) {
+            int64_t v;
+            memcpy(&v, p, 8);
+            stream << static_cast<long long>(v);
+        } else if (type == UInt) {
+            uint64_t v;
+            memcpy(&v, p, 8);
+            stream << static_cast<unsigned long long>(v);
+        } else if (type == Double) {
+            double v;
+            memcpy(&v, p, 8);
+            stream << v;
+        } else {
+            uintptr_t v;
+            memcpy(&v, p, 8);
+            stream << reinterpret_cast<const void *>(v);
+        }
+        p += 8;
+    }
+    stream << format;
+}
@@ -0,0 +1,176 @@
+#include "base/FlightRecorder.h"
+#include "base/CurrentThread.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr size_t MaxThreads = 256;
+    //信号处理函数中遍历，只追加不删除；线程退出后其环保留
+    std::atomic<void *> g_rings[MaxThreads];
+    std::atomic_size_t g_num_rings{0};
+    std::atomic_flag g_dumping = ATOMIC_FLAG_INIT;
+
+    const char *const TypeNames[FlightRecorder::NumEventTypes] = {
+            "poll",
+            "accept",
+            "read",
+            "write",
+            "close",
+            "timer",
+            "functors",
+    };
+
+    /* 异步信号安全的输出缓冲 */
+    class Writer {
+    public:
+        explicit Writer(int fd) : fd_(fd), len_(0) {}
+
+        ~Writer() {
+            flush();
+        }
+
+        Writer &str(const char *s) {
+            while (*s) {
+                put(*s++);
+            }
+            return *this;
+        }
+
+        Writer &num(int64_t v, int min_width = 1) {
+            char tmp[24];
+            int n = 0;
+            uint64_t u = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+            do {
+                tmp[n++] = static_cast<char>('0' + u % 10);
+                u /= 10;
+            } while (u > 0 || n < min_width);
+            if (v < 0) {
+                put('-');
+            }
+            while (n > 0) {
+                put(tmp[--n]);
+            }
+            return *this;
+        }
+
+        void flush() {
+            size_t off = 0;
+            while (off < len_) {
+                ssize_t n = ::write(fd_, buf_ + off, len_ - off);
+                if (n <= 0) {
+                    break;
+                }
+                off += static_cast<size_t>(n);
+            }
+            len_ = 0;
+        }
+
+    private:
+        void put(char c) {
+            if (len_ == sizeof(buf_)) {
+                flush();
+            }
+            buf_[len_++] = c;
+        }
+
+        int fd_;
+        size_t len_;
+        char buf_[4096];
+    };
+
+    void dumpSignalHandler(int) {
+        FlightRecorder::dump(STDERR_FILENO);
+    }
+
+    void fatalSignalHandler(int sig) {
+        Writer(STDERR_FILENO).str("FlightRecorder: caught signal ").num(sig).str("\n");
+        FlightRecorder::dump(STDERR_FILENO);
+        ::signal(sig, SIG_DFL);
+        ::raise(sig);
+    }
+}// namespace
+
+void FlightRecorder::enable(size_t events_per_thread) {
+    size_t size = 64;
+    while (size < events_per_thread) {
+        size <<= 1;
+    }
+    TscClock::cycles();//在正常上下文中完成校准
+    events_per_thread_ = size;
+}
+
+void FlightRecorder::attachThread(const char *name) {
+    size_t size = events_per_thread_.load(std::memory_order_relaxed);
+    if (size == 0 || t_ring_ != nullptr) {
+        return;
+    }
+    size_t slot = g_num_rings.load(std::memory_order_relaxed);
+    if (slot >= MaxThreads) {
+        return;
+    }
+    auto *ring = new Ring;
+    ring->events = new Event[size]();
+    ring->mask = size - 1;
+    ring->tid = CurrentThread::tid();
+    strncpy(ring->name, name ? name : "", sizeof(ring->name) - 1);
+    ring->name[sizeof(ring->name) - 1] = '\0';
+    ring->next.store(0, std::memory_order_relaxed);
+    slot = g_num_rings.fetch_add(1);
+    if (slot >= MaxThreads) {
+        g_num_rings.fetch_sub(1);
+        delete[] ring->events;
+        delete ring;
+        return;
+    }
+    g_rings[slot].store(ring, std::memory_order_release);
+    t_ring_ = ring;
+}
+
+void FlightRecorder::dump(int fd) {
+    if (g_dumping.test_and_set()) {//同时只有一个dump，避免在FATAL和信号中重入
+        return;
+    }
+    uint64_t now = TscClock::cycles();
+    Writer out(fd);
+    size_t num_rings = std::min(g_num_rings.load(), MaxThreads);
+    for (size_t i = 0; i < num_rings; ++i) {
+        auto *ring = static_cast<Ring *>(g_rings[i].load(std::memory_order_acquire));
+        if (ring == nullptr) {
+            continue;
+        }
+        uint64_t next = ring->next.load(std::memory_order_acquire);
+        uint64_t capacity = ring->mask + 1;
+        uint64_t first = next > capacity ? next - capacity : 0;
+        out.str("==== FlightRecorder thread ").num(ring->tid).str(" ").str(ring->name)
+                .str(" events ").num(static_cast<int64_t>(next - first)).str("/").num(static_cast<int64_t>(next))
+                .str(" ====\n");
+        for (uint64_t j = first; j < next; ++j) {
+            const Event &event = ring->events[j & ring->mask];
+            int64_t ago_ns = event.cycles <= now ? TscClock::toNanos(now - event.cycles) : 0;
+            out.str("-").num(ago_ns / 1000000).str(".").num(ago_ns / 1000 % 1000, 3).str("ms ")
+                    .str(event.type < NumEventTypes ? TypeNames[event.type] : "?");
+            if (event.fd >= 0) {
+                out.str(" fd=").num(event.fd);
+            }
+            out.str(" ").num(event.value).str("\n");
+        }
+    }
+    out.flush();
+    g_dumping.clear();
+}
+
+void FlightRecorder::installSignalHandlers(int dump_signal) {
+    TscClock::cycles();
+    struct sigaction sa {};
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = fatalSignalHandler;
+    sa.sa_flags = SA_RESETHAND;
+    for (int sig: {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+        ::sigaction(sig, &sa, nullptr);
+    }
+    if (dump_signal != 0) {
+        sa.sa_handler = dumpSignalHandler;
+        sa.sa_flags = SA_RESTART;
+        ::sigaction(dump_signal, &sa, nullptr);
+    }
+}
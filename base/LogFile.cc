@@ -0,0 +1,96 @@
+#include "base/LogFile.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+LogFile::LogFile(std::string basename, off_t roll_size, int flush_interval, int roll_interval)
+    : basename_(std::move(basename)), roll_size_(roll_size),
+      flush_interval_(flush_interval), roll_interval_(roll_interval > 0 ? roll_interval : 24 * 3600),
+      fp_(nullptr), written_bytes_(0), count_(0),
+      start_of_period_(0), last_roll_(0), last_flush_(0) {
+    rollFile();
+}
+
+LogFile::~LogFile() {
+    if (fp_) {
+        ::fclose(fp_);
+    }
+}
+
+void LogFile::append(const char *logline, size_t len) {
+    if (fp_ == nullptr) {
+        return;
+    }
+    size_t written = 0;
+    while (written != len) {
+        size_t n = ::fwrite_unlocked(logline + written, 1, len - written, fp_);
+        if (n == 0) {
+            int err = ferror(fp_);
+            if (err) {
+                fprintf(stderr, "LogFile::append() failed %s\n", strerror(err));
+            }
+            break;
+        }
+        written += n;
+    }
+    written_bytes_ += static_cast<off_t>(written);
+
+    if (written_bytes_ > roll_size_) {
+        rollFile();
+    } else if (++count_ >= CheckTimeEveryN) {//每N次检查一次时间
+        count_ = 0;
+        time_t now = ::time(nullptr);
+        time_t this_period = now / roll_interval_ * roll_interval_;
+        if (this_period != start_of_period_) {
+            rollFile();
+        } else if (now - last_flush_ > flush_interval_) {
+            last_flush_ = now;
+            ::fflush(fp_);
+        }
+    }
+}
+
+void LogFile::flush() {
+    if (fp_) {
+        ::fflush(fp_);
+    }
+}
+
+bool LogFile::rollFile() {
+    time_t now = ::time(nullptr);
+    if (now <= last_roll_ && fp_ != nullptr) {//一秒内不重复滚动，避免同名文件
+        return false;
+    }
+    FILE *fp = ::fopen(logFileName(now).c_str(), "ae");
+    if (fp == nullptr) {
+        fprintf(stderr, "LogFile::rollFile() open failed %s\n", strerror(errno));
+        return false;
+    }
+    if (fp_) {
+        ::fclose(fp_);
+    }
+    fp_ = fp;
+    ::setbuffer(fp_, buffer_, sizeof(buffer_));
+    written_bytes_ = 0;
+    last_roll_ = now;
+    last_flush_ = now;
+    start_of_period_ = now / roll_interval_ * roll_interval_;
+    return true;
+}
+
+std::string LogFile::logFileName(time_t now) const {
+    std::string filename = basename_;
+    char buf[64];
+    tm tm_time{};
+    localtime_r(&now, &tm_time);
+    strftime(buf, sizeof(buf), ".%Y%m%d-%H%M%S.", &tm_time);
+    filename += buf;
+    char hostname[256] = {0};
+    if (::gethostname(hostname, sizeof(hostname) - 1) != 0) {
+        strcpy(hostname, "unknownhost");
+    }
+    filename += hostname;
+    snprintf(buf, sizeof(buf), ".%d.log", ::getpid());
+    filename += buf;
+    return filename;
+}
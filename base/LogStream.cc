@@ -0,0 +1,115 @@
+#include "base/LogStream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+namespace {
+    const char Digits[] = "9876543210123456789";
+    const char *const Zero = Digits + 9;
+    const char DigitsHex[] = "0123456789abcdef";
+
+    //从低位开始转换再翻转，负数逐位取余，避免最小值取反溢出
+    template<typename T>
+    size_t convert(char buf[], T value) {
+        T i = value;
+        char *p = buf;
+        do {
+            int lsd = static_cast<int>(i % 10);
+            i /= 10;
+            *p++ = Zero[lsd];
+        } while (i != 0);
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                *p++ = '-';
+            }
+        }
+        *p = '\0';
+        std::reverse(buf, p);
+        return static_cast<size_t>(p - buf);
+    }
+
+    size_t convertHex(char buf[], uintptr_t value) {
+        uintptr_t i = value;
+        char *p = buf;
+        do {
+            *p++ = DigitsHex[i % 16];
+            i /= 16;
+        } while (i != 0);
+        *p = '\0';
+        std::reverse(buf, p);
+        return static_cast<size_t>(p - buf);
+    }
+
+    /* 最多保留6位小数并去掉末尾的0，与%g在常见范围内的输出一致
+     * 超出范围（很大、很小、非有限值）时交给snprintf
+     * */
+    size_t convertDouble(char buf[], size_t size, double value) {
+        double abs = std::fabs(value);
+        if (!std::isfinite(value) || abs >= 1e12 || (abs < 1e-4 && abs != 0)) {
+            return static_cast<size_t>(snprintf(buf, size, "%.12g", value));
+        }
+        const int64_t Scale = 1000000;
+        auto scaled = static_cast<int64_t>(std::llround(abs * Scale));
+        int64_t integer = scaled / Scale;
+        int64_t fraction = scaled % Scale;
+        char *p = buf;
+        if (value < 0 && scaled != 0) {
+            *p++ = '-';
+        }
+        p += convert(p, integer);
+        if (fraction != 0) {
+            *p++ = '.';
+            int width = 6;
+            while (fraction % 10 == 0) {
+                fraction /= 10;
+                --width;
+            }
+            char digits[8];
+            size_t n = convert(digits, fraction);
+            for (size_t i = n; i < static_cast<size_t>(width); ++i) {
+                *p++ = '0';
+            }
+            memcpy(p, digits, n);
+            p += n;
+        }
+        *p = '\0';
+        return static_cast<size_t>(p - buf);
+    }
+}// namespace
+
+template<typename T>
+void LogStream::formatInteger(T v) {
+    if (buffer_.avail() >= MaxNumericSize) {
+        size_t len = convert(buffer_.current(), v);
+        buffer_.add(len);
+    }
+}
+
+template void LogStream::formatInteger(int);
+template void LogStream::formatInteger(unsigned int);
+template void LogStream::formatInteger(long);
+template void LogStream::formatInteger(unsigned long);
+template void LogStream::formatInteger(long long);
+template void LogStream::formatInteger(unsigned long long);
+
+LogStream &LogStream::operator<<(const void *p) {
+    auto v = reinterpret_cast<uintptr_t>(p);
+    if (buffer_.avail() >= MaxNumericSize) {
+        char *buf = buffer_.current();
+        buf[0] = '0';
+        buf[1] = 'x';
+        size_t len = convertHex(buf + 2, v);
+        buffer_.add(len + 2);
+    }
+    return *this;
+}
+
+LogStream &LogStream::operator<<(double v) {
+    if (buffer_.avail() >= MaxNumericSize) {
+        size_t len = convertDouble(buffer_.current(), MaxNumericSize, v);
+        buffer_.add(len);
+    }
+    return *this;
+}
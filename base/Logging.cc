@@ -0,0 +1,73 @@
+#include "base/Logging.h"
+#include "base/CurrentThread.h"
+#include "base/FlightRecorder.h"
+#include <cstdio>
+#include <ctime>
+
+namespace {
+    const char *const LevelNames[Logger::NumLogLevels] = {
+            "TRACE ",
+            "DEBUG ",
+            "INFO  ",
+            "WARN  ",
+            "ERROR ",
+            "FATAL ",
+    };
+
+    //本线程上次格式化的秒及结果 "YYYY-mm-dd HH:MM:SS"
+    thread_local time_t t_last_second = 0;
+    thread_local char t_time[32];
+    thread_local size_t t_time_length = 0;
+}// namespace
+
+Logger::Logger(SourceFile file, int line, LogLevel level)
+    : file_(file), line_(line), level_(level) {
+    timespec ts{};
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    formatTime(ts);
+    stream_.append(CurrentThread::tidString(), static_cast<size_t>(CurrentThread::tidStringLength()));
+    stream_.append(" ", 1);
+    stream_.append(LevelNames[level], 6);
+}
+
+Logger::Logger(SourceFile file, int line, LogLevel level, int64_t realtime_ns, int tid)
+    : file_(file), line_(line), level_(level) {
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(realtime_ns / Timestamp::NanoSecondsPerSecond);
+    ts.tv_nsec = static_cast<long>(realtime_ns % Timestamp::NanoSecondsPerSecond);
+    formatTime(ts);
+    stream_ << tid << ' ';
+    stream_.append(LevelNames[level], 6);
+}
+
+Logger::~Logger() {
+    stream_ << ' ';
+    stream_.append(file_.data_, file_.size_);
+    stream_ << ':' << line_ << '\n';
+    const LogStream::Buffer &buf = stream_.buffer();
+    g_output_(buf.data(), buf.length());
+    if (level_ == FATAL) {
+        FlightRecorder::dump();
+        g_flush_();
+    }
+}
+
+void Logger::formatTime(const timespec &ts) {
+    if (ts.tv_sec != t_last_second) {
+        t_last_second = ts.tv_sec;
+        tm tm_time{};
+        localtime_r(&ts.tv_sec, &tm_time);
+        int n = snprintf(t_time, sizeof(t_time), "%4d-%02d-%02d %02d:%02d:%02d",
+                         tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
+                         tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
+        t_time_length = static_cast<size_t>(n);
+    }
+    stream_.append(t_time, t_time_length);
+    char micros[9] = {'.', '0', '0', '0', '0', '0', '0', ' ', '\0'};
+    long us = ts.tv_nsec / 1000;
+    for (int i = 6; i >= 1; --i) {
+        micros[i] = static_cast<char>('0' + us % 10);
+        us /= 10;
+    }
+    stream_.append(micros, 8);
+}
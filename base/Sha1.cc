@@ -0,0 +1,90 @@
+#include "base/Sha1.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+}// namespace
+
+Sha1::Sha1()
+    : state_{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0}, length_(0), block_(), block_len_(0) {}
+
+void Sha1::update(const void *data, size_t len) {
+    const auto *p = static_cast<const uint8_t *>(data);
+    length_ += len;
+    if (block_len_ > 0) {
+        size_t n = std::min(len, sizeof(block_) - block_len_);
+        memcpy(block_ + block_len_, p, n);
+        block_len_ += n;
+        p += n;
+        len -= n;
+        if (block_len_ < sizeof(block_)) {
+            return;
+        }
+        processBlock(block_);
+        block_len_ = 0;
+    }
+    for (; len >= sizeof(block_); p += sizeof(block_), len -= sizeof(block_)) {
+        processBlock(p);
+    }
+    memcpy(block_, p, len);
+    block_len_ = len;
+}
+
+Sha1::Digest Sha1::final() {
+    uint64_t bits = length_ * 8;
+    uint8_t padding[72] = {0x80};
+    size_t pad_len = block_len_ < 56 ? 56 - block_len_ : 120 - block_len_;
+    for (int i = 0; i < 8; ++i) {
+        padding[pad_len + i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    }
+    update(padding, pad_len + 8);
+    Digest digest;
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            digest[i * 4 + j] = static_cast<uint8_t>(state_[i] >> (24 - 8 * j));
+        }
+    }
+    return digest;
+}
+
+void Sha1::processBlock(const uint8_t *block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+               static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+}
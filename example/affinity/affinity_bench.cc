@@ -0,0 +1,96 @@
+#include "base/CpuAffinity.h"
+#include "base/Logging.h"
+#include "net/EventLoop.h"
+#include "net/EventLoopThread.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/* 回环pingpong吞吐测试，对比io线程不绑核/每线程绑单核/按NUMA节点绑核
+ * 跨节点流量可配合 perf stat -e node-loads,node-load-misses 观察
+ * */
+
+std::atomic_int64_t g_bytes{0};
+
+std::vector<CpuAffinity::CpuSet> serverCpuSets(const std::string &mode, int threads) {
+    std::vector<CpuAffinity::CpuSet> sets;
+    if (mode == "cpu") {
+        for (int i = 0; i < threads; ++i) {
+            sets.push_back({i % CpuAffinity::numCpus()});
+        }
+    } else if (mode == "node") {
+        sets.push_back(CpuAffinity::cpusOfNode(0));
+    }
+    return sets;
+}
+
+CpuAffinity::CpuSet clientCpuSet(const std::string &mode, int threads, int i) {
+    if (mode == "cpu") {
+        return {(threads + i) % CpuAffinity::numCpus()};
+    } else if (mode == "node") {
+        CpuAffinity::CpuSet remote = CpuAffinity::cpusOfNode(1);
+        return remote.empty() ? CpuAffinity::cpusOfNode(0) : remote;
+    }
+    return {};
+}
+
+int main(int argc, char **argv) {
+    if (argc < 6) {
+        printf("usage: %s <port> <threads> <clients> <block_size> <seconds> [none|cpu|node]\n", argv[0]);
+        return 2;
+    }
+    Logger::setGLevel(Logger::WARN);
+    uint16_t port = std::stoul(argv[1]);
+    int threads = std::stoi(argv[2]);
+    int clients = std::stoi(argv[3]);
+    size_t block_size = std::stoul(argv[4]);
+    int seconds = std::stoi(argv[5]);
+    std::string mode = argc > 6 ? argv[6] : "none";
+
+    EventLoopThread server_thread;
+    EventLoop *server_loop = server_thread.startLoop();
+    TcpServer server(server_loop, InetAddress(port), "AffinityBench");
+    server.setThreadNum(threads);
+    server.setThreadAffinity(serverCpuSets(mode, threads));
+    server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+        conn->send(buf->retrieveAllAsString());
+    });
+    server.start();
+
+    std::string block(block_size, 'x');
+    std::vector<std::unique_ptr<EventLoopThread>> client_threads;
+    std::vector<std::unique_ptr<TcpClient>> tcp_clients;
+    for (int i = 0; i < threads; ++i) {
+        client_threads.push_back(std::make_unique<EventLoopThread>(EventLoopThread::ThreadInitCallback(),
+                                                                   "client" + std::to_string(i),
+                                                                   clientCpuSet(mode, threads, i)));
+    }
+    std::vector<EventLoop *> client_loops;
+    for (auto &t: client_threads) {
+        client_loops.push_back(t->startLoop());
+    }
+    for (int i = 0; i < clients; ++i) {
+        auto client = std::make_unique<TcpClient>(client_loops[i % client_loops.size()], InetAddress(port), "client");
+        client->setConnectionCallback([&block](const TcpConnectionPtr &conn) {
+            if (conn->connect()) {
+                conn->send(block);
+            }
+        });
+        client->setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+            g_bytes += static_cast<int64_t>(buf->readableBytes());
+            conn->send(buf->retrieveAllAsString());
+        });
+        client->connect();
+        tcp_clients.push_back(std::move(client));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    double mib = static_cast<double>(g_bytes.load()) / 1024 / 1024;
+    printf("mode=%s threads=%d clients=%d block=%zu: %.2f MiB/s\n",
+           mode.c_str(), threads, clients, block_size, mib / seconds);
+    fflush(stdout);
+    _exit(0);
+}
@@ -0,0 +1,65 @@
+#include "base/Logging.h"
+#include "net/ComputeThreadPool.h"
+#include "net/EventLoop.h"
+#include "net/TcpServer.h"
+#include <charconv>
+#include <iostream>
+#include <string>
+
+/* 每行一个整数n，返回不大于n的素数个数
+ * 计算放到ComputeThreadPool中，同一连接的响应保持请求顺序；不是整数的行返回error
+ * */
+
+int countPrimes(int n) {
+    int count = 0;
+    for (int i = 2; i <= n; ++i) {
+        bool prime = true;
+        for (int j = 2; j * j <= i; ++j) {
+            if (i % j == 0) {
+                prime = false;
+                break;
+            }
+        }
+        count += prime;
+    }
+    return count;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage:" << argv[0] << " port [io_threads] [compute_threads]" << std::endl;
+        return 2;
+    }
+    auto port = std::stoul(argv[1]);
+    int io_threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    int compute_threads = argc > 3 ? std::stoi(argv[3]) : 4;
+
+    ComputeThreadPool pool(compute_threads);
+    pool.start();
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port), "ComputeServer");
+    server.setThreadNum(io_threads);
+    server.setConnectionCallback([](const TcpConnectionPtr &conn) {
+        if (conn->connect()) {
+            conn->setContext(std::make_shared<ComputeSequencer>(conn->getLoop()));
+        }
+    });
+    server.setMessageCallback([&pool](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+        auto sequencer = std::any_cast<std::shared_ptr<ComputeSequencer>>(*conn->getContext());
+        while (const char *crlf = buf->findCRLF()) {
+            int n = 0;
+            auto [end, ec] = std::from_chars(buf->peek(), crlf, n);
+            bool valid = ec == std::errc() && end == crlf;
+            buf->retrieve(crlf + 2 - buf->peek());
+            if (!valid) {
+                sequencer->post([conn] { conn->send(std::string("error invalid number\r\n")); });
+                continue;
+            }
+            sequencer->offload(
+                    &pool, [n] { return countPrimes(n); },
+                    [conn, n](int result) { conn->send(std::to_string(n) + " " + std::to_string(result) + "\r\n"); });
+        }
+    });
+    server.start();
+    loop.loop();
+}
@@ -1,5 +1,7 @@
+#include "base/FlightRecorder.h"
 #include "net/EventLoop.h"
 #include "net/TcpServer.h"
+#include <iostream>
 
 class EchoServer {
 public:
@@ -30,6 +32,8 @@ int main(int argc, char **argv) {
     }
     auto port = std::stoul(argv[1]);
     LOG_INFO << "listen port:" << port;
+    FlightRecorder::enable();//kill -USR2 输出各loop最近的事件
+    FlightRecorder::installSignalHandlers();
     EventLoop loop;
     EchoServer server(&loop, InetAddress(port));
     server.start();
@@ -0,0 +1,45 @@
+#include "net/EventLoop.h"
+#include "net/ListenerHandoff.h"
+#include "net/TcpServer.h"
+#include <iostream>
+#include <unistd.h>
+
+/* 不停机重启的echo服务器
+ * 启动时先尝试从path上的旧进程接管listen socket，没有旧进程则自己bind
+ * 之后在path上等待下一个进程，交接后drain已有连接再退出
+ * 升级时直接启动新进程即可：handoff_server 8000 /tmp/echo.sock
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cout << "usage:" << argv[0] << " port unix_path [threads] [drain_seconds]" << std::endl;
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    std::string path = argv[2];
+    int threads = argc > 3 ? std::stoi(argv[3]) : 2;
+    double drain_seconds = argc > 4 ? std::stod(argv[4]) : 30.0;
+
+    EventLoop loop;
+    std::vector<int> fds = ListenerHandoff::takeOver(path);
+    LOG_INFO << "pid " << getpid() << (fds.empty() ? " bind port " : " inherited port ") << port;
+    TcpServer server(&loop, InetAddress(port), "HandoffServer", std::move(fds), TcpServer::PerLoopReusePort);
+    server.setThreadNum(threads);
+    server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+        conn->send(buf->retrieveAllAsString());
+    });
+    server.start();
+
+    ListenerHandoff handoff(&loop, path);
+    handoff.setListenFdsProvider([&server] { return server.listenFds(); });
+    handoff.setHandoffCallback([&] {
+        server.drain(drain_seconds, [&loop](size_t remaining, bool done) {
+            LOG_INFO << "pid " << getpid() << " draining, " << remaining << " connections left";
+            if (done) {
+                loop.quit();
+            }
+        });
+    });
+    handoff.start();
+    loop.loop();
+}
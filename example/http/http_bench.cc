@@ -0,0 +1,121 @@
+#include "net/EventLoop.h"
+#include "net/EventLoopThread.h"
+#include "net/TcpClient.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* 类似wrk的回环压测：每个连接保持pipeline个未完成的请求，收到一个响应就再发一个
+ * http_bench port [connections] [pipeline] [seconds] [threads] [path]
+ * */
+
+std::atomic_uint64_t g_responses{0};
+std::atomic_uint64_t g_errors{0};
+
+class BenchConnection {
+public:
+    BenchConnection(EventLoop *loop, const InetAddress &addr, int pipeline, const std::string &request)
+        : client_(loop, addr, "http_bench"), pipeline_(pipeline), request_(request) {
+        client_.setConnectionCallback([this](const TcpConnectionPtr &conn) {
+            if (conn->connect()) {
+                std::string batch;
+                for (int i = 0; i < pipeline_; ++i) {
+                    batch += request_;
+                }
+                conn->send(batch);
+            }
+        });
+        client_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) { onMessage(conn, buf); });
+    }
+
+    void connect() {
+        client_.connect();
+    }
+
+private:
+    //只解析状态行之后的Content-Length，足够统计本库和常见服务器的响应
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf) {
+        int completed = 0;
+        while (true) {
+            const char *begin = buf->peek();
+            size_t readable = buf->readableBytes();
+            const char *end = static_cast<const char *>(memmem(begin, readable, "\r\n\r\n", 4));
+            if (end == nullptr) {
+                break;
+            }
+            size_t header_size = static_cast<size_t>(end - begin) + 4;
+            size_t body_size = 0;
+            const char *cl = static_cast<const char *>(memmem(begin, header_size, "Content-Length: ", 16));
+            if (cl != nullptr) {
+                body_size = std::strtoul(cl + 16, nullptr, 10);
+            }
+            if (readable < header_size + body_size) {
+                break;
+            }
+            if (memcmp(begin, "HTTP/1.1 200", 12) != 0) {
+                ++g_errors;
+            }
+            buf->retrieve(header_size + body_size);
+            ++completed;
+        }
+        if (completed > 0) {
+            g_responses += static_cast<uint64_t>(completed);
+            std::string batch;
+            for (int i = 0; i < completed; ++i) {
+                batch += request_;
+            }
+            conn->send(batch);
+        }
+    }
+
+    TcpClient client_;
+    int pipeline_;
+    const std::string &request_;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [connections] [pipeline] [seconds] [threads] [path]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int connections = argc > 2 ? std::stoi(argv[2]) : 64;
+    int pipeline = argc > 3 ? std::stoi(argv[3]) : 1;
+    int seconds = argc > 4 ? std::stoi(argv[4]) : 5;
+    int num_threads = argc > 5 ? std::stoi(argv[5]) : 2;
+    std::string path = argc > 6 ? argv[6] : "/";
+    Logger::setGLevel(Logger::WARN);
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: http_bench\r\n\r\n";
+
+    std::vector<std::unique_ptr<EventLoopThread>> threads;
+    std::vector<EventLoop *> loops;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(std::make_unique<EventLoopThread>());
+        loops.push_back(threads.back()->startLoop());
+    }
+    InetAddress addr(port);
+    std::vector<std::unique_ptr<BenchConnection>> conns;
+    for (int i = 0; i < connections; ++i) {
+        conns.emplace_back(std::make_unique<BenchConnection>(loops[i % loops.size()], addr, pipeline, request));
+        conns.back()->connect();
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));//预热
+    uint64_t start_count = g_responses;
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    uint64_t count = g_responses - start_count;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%d connections, pipeline %d, %d threads: %.0f requests/s, %llu non-200\n", connections, pipeline,
+           num_threads, static_cast<double>(count) / elapsed, static_cast<unsigned long long>(g_errors.load()));
+    //TcpClient需在各自loop中析构，进程即将退出，直接放弃这些连接
+    for (auto &conn: conns) {
+        conn.release();
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "net/EventLoop.h"
+#include "net/http/HttpServer.h"
+#include <iostream>
+#include <string>
+
+/* http_server port [threads]
+ * GET /       返回hello world
+ * POST /echo  原样返回请求体（支持chunked）
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage:" << argv[0] << " port [threads]" << std::endl;
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    Logger::setGLevel(Logger::WARN);
+    EventLoop loop;
+    HttpServer server(&loop, InetAddress(port, "0.0.0.0"), "HttpServer");
+    server.setThreadNum(threads);
+    server.setHttpCallback([](const HttpRequest &request, HttpResponse *response) {
+        if (request.path() == "/") {
+            response->setContentType("text/plain");
+            response->setBodyView("hello world\n");
+        } else if (request.path() == "/echo" && request.method() == HttpRequest::Post) {
+            response->setContentType("application/octet-stream");
+            response->setBody(std::string(request.body()));
+        } else {
+            response->setStatus(404);
+        }
+    });
+    server.start();
+    loop.loop();
+}
@@ -0,0 +1,86 @@
+#include "base/AsyncLogging.h"
+#include "base/BinaryLogging.h"
+#include "base/Logging.h"
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* 多线程写日志的吞吐：同步写文件 与 AsyncLogging（各溢出策略），以及二进制日志在调用线程上的开销
+ * async_log_bench [threads] [lines_per_thread] [max_buffers]
+ * 日志写到当前目录下的 async_log_bench.* 文件
+ * */
+
+int g_sync_fd = -1;
+AsyncLogging *g_async = nullptr;
+
+void syncOutput(const char *msg, size_t len) {
+    ::write(g_sync_fd, msg, len);
+}
+
+void asyncOutput(const char *msg, size_t len) {
+    g_async->append(msg, len);
+}
+
+double run(int num_threads, int lines, bool binary = false) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([lines, binary] {
+            for (int i = 0; i < lines; ++i) {
+                if (binary) {
+                    LOG_BIN_INFO("async_log_bench line {} {}", i, "abcdefghijklmnopqrstuvwxyz");
+                } else {
+                    LOG_INFO << "async_log_bench line " << i << " abcdefghijklmnopqrstuvwxyz";
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, double seconds, size_t total, uint64_t dropped) {
+    printf("%-12s %8.3fs %10.0f lines/s dropped %llu\n", name, seconds, static_cast<double>(total) / seconds,
+           static_cast<unsigned long long>(dropped));
+}
+
+int main(int argc, char *argv[]) {
+    int num_threads = argc > 1 ? std::stoi(argv[1]) : 4;
+    int lines = argc > 2 ? std::stoi(argv[2]) : 200000;
+    size_t max_buffers = argc > 3 ? std::stoul(argv[3]) : 16;
+    size_t total = static_cast<size_t>(num_threads) * lines;
+
+    g_sync_fd = ::open("async_log_bench.sync.log", O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    Logger::setOutput(syncOutput);
+    report("sync", run(num_threads, lines), total, 0);
+    ::close(g_sync_fd);
+
+    const std::pair<const char *, AsyncLogging::OverflowPolicy> policies[] = {
+            {"DropOldest", AsyncLogging::DropOldest},
+            {"DropNewest", AsyncLogging::DropNewest},
+            {"Block", AsyncLogging::Block},
+    };
+    for (const auto &policy: policies) {
+        AsyncLogging async(std::string("async_log_bench.") + policy.first, 500 * 1000 * 1000, 3, max_buffers,
+                           policy.second);
+        async.start();
+        g_async = &async;
+        Logger::setOutput(asyncOutput);
+        double seconds = run(num_threads, lines);
+        report(policy.first, seconds, total, async.dropped());
+        if (policy.second == AsyncLogging::DropOldest) {//调用线程只写二进制记录，格式化在后台线程
+            BinaryLogging::start(16 * 1024 * 1024, 10);
+            seconds = run(num_threads, lines, true);
+            report("Binary", seconds, total, BinaryLogging::dropped());
+            BinaryLogging::stop();
+        }
+        async.stop();
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "net/EventLoop.h"
+#include "net/redis/RedisClient.h"
+#include <cstdio>
+#include <string>
+
+/* 先执行几条命令打印回复，再在一条连接上保持in_flight个未回复的GET，收到一个回复就再发一个
+ * 可以对redis_mock_server或真实的Redis运行
+ * redis_bench port [in_flight] [seconds]
+ * */
+
+void print(const RespValue &value, int indent) {
+    printf("%*s", indent * 2, "");
+    if (value.isNull()) {
+        printf("(nil)\n");
+    } else if (value.type() == RespValue::Integer || value.type() == RespValue::Boolean) {
+        printf("(integer) %lld\n", static_cast<long long>(value.integer()));
+    } else if (value.isAggregate()) {
+        printf("(%c%zu)\n", value.type(), value.size());
+        for (size_t i = 0; i < value.size(); ++i) {
+            print(value[i], indent + 1);
+        }
+    } else {
+        std::string str(value.str());
+        printf("%s\"%s\"\n", value.isError() ? "(error) " : "", str.c_str());
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [in_flight] [seconds]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int in_flight = argc > 2 ? std::stoi(argv[2]) : 128;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 5;
+    Logger::setGLevel(Logger::WARN);
+
+    EventLoop loop;
+    RedisClient client(&loop, InetAddress(port), "redis_bench");
+    auto show = [](RedisClient::Status status, const RespValue &reply) {
+        if (status == RedisClient::Ok) {
+            print(reply, 0);
+        }
+    };
+    //连接建立前发出，连接后合并为一次write
+    client.command({"SET", "bench:key", "hello"}, show);
+    client.command({"GET", "bench:key"}, show);
+    client.command({"INCR", "bench:counter"}, show);
+    client.command({"GET", "bench:missing"}, show);
+    client.command({"HELLO", "3"}, show);
+    client.command({"GET", "bench:missing"}, show);
+
+    uint64_t ok = 0;
+    uint64_t failed = 0;
+    bool running = true;
+    std::function<void()> issue = [&] {
+        client.command({"GET", "bench:key"}, [&](RedisClient::Status status, const RespValue &reply) {
+            status == RedisClient::Ok && !reply.isError() ? ++ok : ++failed;
+            if (running) {
+                issue();
+            }
+        });
+    };
+    client.command({"PING"}, [&](RedisClient::Status status, const RespValue &) {
+        if (status != RedisClient::Ok) {
+            loop.quit();
+            return;
+        }
+        for (int i = 0; i < in_flight; ++i) {
+            issue();
+        }
+        loop.runAfter(seconds, [&] {
+            running = false;
+            printf("in_flight %d: %.0f GET/s, %llu failed\n", in_flight, static_cast<double>(ok) / seconds,
+                   static_cast<unsigned long long>(failed));
+            loop.quit();
+        });
+    });
+    client.connect();
+    loop.loop();
+}
@@ -0,0 +1,141 @@
+#include "net/EventLoop.h"
+#include "net/TcpServer.h"
+#include "net/redis/RespParser.h"
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/* 离线测试用的Redis模拟服务器，数据在内存中
+ * 支持PING、ECHO、SET、GET、DEL、INCR、HELLO；HELLO 3之后按RESP3回复（Map、Null）
+ * 一次读到的命令的回复合并为一次send
+ * redis_mock_server port [threads]
+ * */
+
+class MockServer {
+public:
+    MockServer(EventLoop *loop, const InetAddress &addr) : server_(loop, addr, "RedisMock") {
+        server_.setConnectionCallback([](const TcpConnectionPtr &conn) {
+            if (conn->connect()) {
+                conn->setContext(Session());
+            }
+        });
+        server_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) { onMessage(conn, buf); });
+    }
+
+    void setThreadNum(int num) {
+        server_.setThreadNum(num);
+    }
+
+    void start() {
+        server_.start();
+    }
+
+private:
+    struct Session {
+        RespParser parser;
+        int protocol = 2;
+    };
+
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf) {
+        auto *session = std::any_cast<Session>(conn->getMutableContext());
+        static thread_local Buffer output;
+        while (buf->readableBytes() > 0) {
+            RespParser::Result result = session->parser.parse(buf);
+            if (result == RespParser::Incomplete) {
+                break;
+            }
+            if (result == RespParser::Error) {
+                output.append(std::string("-ERR Protocol error\r\n"));
+                buf->retrieveAll();
+                conn->send(&output);
+                conn->shutdown();
+                return;
+            }
+            execute(session, session->parser.reply(), &output);
+            buf->retrieve(session->parser.replySize());
+            session->parser.reset();
+        }
+        if (output.readableBytes() > 0) {
+            conn->send(&output);
+        }
+    }
+
+    static void bulk(Buffer *out, std::string_view str) {
+        out->append("$" + std::to_string(str.size()) + "\r\n");
+        out->append(str.data(), str.size());
+        out->append(CRLF, 2);
+    }
+
+    void execute(Session *session, const RespValue &command, Buffer *out) {
+        if (command.type() != RespValue::Array || command.size() == 0) {
+            out->append(std::string("-ERR expected array of bulk strings\r\n"));
+            return;
+        }
+        std::string name(command[0].str());
+        for (char &c: name) {
+            c = static_cast<char>(toupper(c));
+        }
+        size_t argc = command.size();
+        if (name == "PING") {
+            argc > 1 ? bulk(out, command[1].str()) : out->append(std::string("+PONG\r\n"));
+        } else if (name == "ECHO" && argc == 2) {
+            bulk(out, command[1].str());
+        } else if (name == "SET" && argc == 3) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            data_[std::string(command[1].str())] = std::string(command[2].str());
+            out->append(std::string("+OK\r\n"));
+        } else if (name == "GET" && argc == 2) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = data_.find(std::string(command[1].str()));
+            if (it == data_.end()) {
+                out->append(std::string(session->protocol == 3 ? "_\r\n" : "$-1\r\n"));
+            } else {
+                bulk(out, it->second);
+            }
+        } else if (name == "DEL" && argc >= 2) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t removed = 0;
+            for (size_t i = 1; i < argc; ++i) {
+                removed += data_.erase(std::string(command[i].str()));
+            }
+            out->append(":" + std::to_string(removed) + "\r\n");
+        } else if (name == "INCR" && argc == 2) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string &value = data_[std::string(command[1].str())];
+            long long n = (value.empty() ? 0 : std::stoll(value)) + 1;
+            value = std::to_string(n);
+            out->append(":" + value + "\r\n");
+        } else if (name == "HELLO") {
+            session->protocol = argc > 1 && command[1].str() == "3" ? 3 : 2;
+            out->append(std::string(session->protocol == 3 ? "%3\r\n" : "*6\r\n"));
+            bulk(out, "server");
+            bulk(out, "redis_mock");
+            bulk(out, "proto");
+            out->append(":" + std::to_string(session->protocol) + "\r\n");
+            bulk(out, "mode");
+            bulk(out, "standalone");
+        } else {
+            out->append("-ERR unknown command '" + name + "'\r\n");
+        }
+    }
+
+    TcpServer server_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::string> data_;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage:" << argv[0] << " port [threads]" << std::endl;
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    Logger::setGLevel(Logger::WARN);
+    EventLoop loop;
+    MockServer server(&loop, InetAddress(port, "0.0.0.0"));
+    server.setThreadNum(threads);
+    server.start();
+    loop.loop();
+}
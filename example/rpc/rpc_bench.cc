@@ -0,0 +1,58 @@
+#include "net/EventLoop.h"
+#include "net/rpc/RpcClient.h"
+#include <cstdio>
+#include <string>
+
+/* 一条连接上保持in_flight个未完成的echo调用，收到一个响应就再发一个
+ * 开始前先发delay 200、delay 100、delay 0三个请求，验证响应乱序返回
+ * rpc_bench port [in_flight] [seconds] [timeout_ms] [payload_size]
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [in_flight] [seconds] [timeout_ms] [payload_size]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int in_flight = argc > 2 ? std::stoi(argv[2]) : 128;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 5;
+    double timeout = (argc > 4 ? std::stod(argv[4]) : 1000) / 1000;
+    std::string payload(argc > 5 ? std::stoul(argv[5]) : 64, 'x');
+    Logger::setGLevel(Logger::WARN);
+
+    EventLoop loop;
+    RpcClient client(&loop, InetAddress(port), "rpc_bench");
+    uint64_t ok = 0;
+    uint64_t failed = 0;
+    bool running = true;
+    std::function<void()> issue = [&] {
+        client.call("echo", payload, [&](RpcClient::Status status, std::string_view) {
+            status == RpcClient::Ok ? ++ok : ++failed;
+            if (running) {
+                issue();
+            }
+        }, timeout);
+    };
+
+    int order_checked = 0;
+    for (const char *ms: {"200", "100", "0"}) {
+        client.call("delay", ms, [&, ms](RpcClient::Status status, std::string_view reply) {
+            printf("delay %s -> %s (%d)\n", ms, status == RpcClient::Ok ? std::string(reply).c_str() : "failed",
+                   ++order_checked);
+            if (order_checked < 3) {
+                return;
+            }
+            for (int i = 0; i < in_flight; ++i) {
+                issue();
+            }
+            loop.runAfter(seconds, [&] {
+                running = false;
+                printf("in_flight %d, payload %zu: %.0f calls/s, %llu failed\n", in_flight, payload.size(),
+                       static_cast<double>(ok) / seconds, static_cast<unsigned long long>(failed));
+                loop.quit();
+            });
+        }, timeout);
+    }
+    client.connect();
+    loop.loop();
+}
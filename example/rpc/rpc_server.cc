@@ -0,0 +1,31 @@
+#include "net/EventLoop.h"
+#include "net/rpc/RpcServer.h"
+#include <iostream>
+#include <string>
+
+/* rpc_server port [threads]
+ * echo   立即原样返回
+ * delay  负载为毫秒数，在该时间之后返回，用来观察同一连接上的乱序响应
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage:" << argv[0] << " port [threads]" << std::endl;
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    Logger::setGLevel(Logger::WARN);
+    EventLoop loop;
+    RpcServer server(&loop, InetAddress(port, "0.0.0.0"), "RpcServer");
+    server.setThreadNum(threads);
+    server.registerMethod("echo", [](const TcpConnectionPtr &, std::string_view payload,
+                                     const RpcServer::Responder &responder) { responder.reply(payload); });
+    server.registerMethod("delay", [](const TcpConnectionPtr &conn, std::string_view payload,
+                                      const RpcServer::Responder &responder) {
+        std::string ms(payload);
+        conn->getLoop()->runAfter(std::stod(ms) / 1000, [responder, ms] { responder.reply(ms); });
+    });
+    server.start();
+    loop.loop();
+}
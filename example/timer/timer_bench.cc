@@ -0,0 +1,128 @@
+#include "base/TscClock.h"
+#include "net/EventLoop.h"
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+/* 比较各TimerQueue实现：插入、取消、插入后立即取消（每请求超时）以及到期执行的开销
+ * 以及不同slack下1秒内2000个定时器引起的唤醒次数，timerfd与poll超时(epoll_pwait2)两种方式
+ * timer_bench [timers] [outstanding] [slack_ms]
+ * */
+
+double nsPerOp(uint64_t start, size_t ops) {
+    return static_cast<double>(TscClock::toNanos(TscClock::cycles() - start)) / static_cast<double>(ops);
+}
+
+void bench(const char *name, TimerQueue::Type type, size_t num_timers, size_t outstanding) {
+    EventLoop loop;
+    loop.setTimerQueueType(type);
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> far(1.0, 60.0);
+
+    //插入大量远期定时器
+    std::vector<TimerId> ids;
+    ids.reserve(num_timers);
+    uint64_t start = TscClock::cycles();
+    for (size_t i = 0; i < num_timers; ++i) {
+        ids.push_back(loop.runAfter(far(rng), [] {}));
+    }
+    double insert_ns = nsPerOp(start, num_timers);
+
+    std::shuffle(ids.begin(), ids.end(), rng);
+    start = TscClock::cycles();
+    for (TimerId id: ids) {
+        loop.cancel(id);
+    }
+    double cancel_ns = nsPerOp(start, num_timers);
+
+    //保持outstanding个超时，每个请求完成时取消最早的一个并添加新的
+    std::deque<TimerId> window;
+    start = TscClock::cycles();
+    for (size_t i = 0; i < num_timers; ++i) {
+        window.push_back(loop.runAfter(30.0, [] {}));
+        if (window.size() > outstanding) {
+            loop.cancel(window.front());
+            window.pop_front();
+        }
+    }
+    double churn_ns = nsPerOp(start, num_timers);
+    for (TimerId id: window) {
+        loop.cancel(id);
+    }
+
+    //200ms内随机到期，检查不提前并统计延迟（从开始loop或到期时间中较晚者算起）
+    std::uniform_int_distribution<int> near(1, 200 * 1000);
+    size_t fired = 0, early = 0;
+    int64_t max_late = 0, total_late = 0;
+    size_t num_fire = std::min<size_t>(num_timers, 100000);
+    Timestamp loop_start;
+    start = TscClock::cycles();
+    for (size_t i = 0; i < num_fire; ++i) {
+        Timestamp when = Timestamp::now() + near(rng) / 1e6;
+        loop.runAt(when, [&, when] {
+            int64_t now = Timestamp::now().microSeconds();
+            early += now < when.microSeconds();
+            int64_t late = now - std::max(when, loop_start).microSeconds();
+            max_late = std::max(max_late, late);
+            total_late += late;
+            if (++fired == num_fire) {
+                loop.quit();
+            }
+        });
+    }
+    loop_start = Timestamp::now();
+    loop.loop();
+    double fire_ns = nsPerOp(start, num_fire);
+
+    std::cout << name << ": insert " << insert_ns << " ns, cancel " << cancel_ns << " ns, churn " << churn_ns
+              << " ns, fire " << fire_ns << " ns/timer, lateness avg " << total_late / static_cast<int64_t>(num_fire)
+              << " us max " << max_late << " us, early " << early << std::endl;
+}
+
+void coalesce(const char *name, TimerQueue::Type type, double slack, bool poll_timers) {
+    EventLoop loop;
+    loop.setTimerQueueType(type);
+    loop.setPollTimers(poll_timers);
+    loop.setTimerSlack(slack);
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> delay(0.001, 1.0);
+    const size_t num_timers = 2000;
+    size_t fired = 0, wakeups = 0, early = 0, overdue = 0;
+    Timestamp last_wakeup;
+    for (size_t i = 0; i < num_timers; ++i) {
+        Timestamp when = Timestamp::now() + delay(rng);
+        loop.runAt(when, [&, when] {
+            if (!(loop.now() == last_wakeup)) {//同一次poll返回的回调now相同
+                last_wakeup = loop.now();
+                ++wakeups;
+            }
+            Timestamp now = Timestamp::now();
+            early += now < when;
+            overdue += timeDifference(now, when) > slack + 0.002;//超出slack 2ms以上
+            if (++fired == num_timers) {
+                loop.quit();
+            }
+        });
+    }
+    loop.loop();
+    std::cout << name << (poll_timers ? " poll   " : " timerfd") << " slack " << slack * 1000 << " ms: " << wakeups << " wakeups for " << num_timers
+              << " timers, early " << early << ", overdue " << overdue << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t num_timers = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t outstanding = argc > 2 ? std::stoul(argv[2]) : 10000;
+    double slack = (argc > 3 ? std::stod(argv[3]) : 10.0) / 1000;
+    //每种实现用一个新线程，保证每个线程只有一个EventLoop
+    std::thread([=] { bench("ordered", TimerQueue::Ordered, num_timers, outstanding); }).join();
+    std::thread([=] { bench("wheel  ", TimerQueue::Wheel, num_timers, outstanding); }).join();
+    for (bool poll_timers: {false, true}) {
+        for (double s: {0.0, slack}) {
+            std::thread([=] { coalesce("ordered", TimerQueue::Ordered, s, poll_timers); }).join();
+            std::thread([=] { coalesce("wheel  ", TimerQueue::Wheel, s, poll_timers); }).join();
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "net/EventLoop.h"
+#include "net/TcpClient.h"
+#include "net/TlsContext.h"
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* 先顺序建立handshakes个短连接（每个回显一次后关闭），统计握手速率和会话复用数；
+ * 再用connections个长连接各保持一条消息来回回显seconds秒，统计吞吐
+ * 不校验服务端证书，可以直接用自签名证书测试
+ * tls_bench port [handshakes] [connections] [seconds] [payload_size]
+ * */
+
+class BenchConnection {
+public:
+    BenchConnection(EventLoop *loop, const InetAddress &addr, TlsContext *context, const std::string &payload,
+                    bool once, std::function<void()> on_close)
+        : client_(loop, addr, "tls_bench"), payload_(payload), once_(once), on_close_(std::move(on_close)),
+          echoes_(0) {
+        client_.setTlsContext(context, "localhost");
+        client_.setConnectionCallback([this](const TcpConnectionPtr &conn) {
+            if (conn->connect()) {
+                conn->send(payload_);//握手完成后发出
+            } else if (on_close_) {
+                on_close_();
+            }
+        });
+        client_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+            if (buf->readableBytes() < payload_.size()) {
+                return;
+            }
+            buf->retrieve(payload_.size());
+            ++echoes_;
+            if (once_) {
+                conn->shutdown();
+            } else {
+                conn->send(payload_);
+            }
+        });
+    }
+
+    void connect() {
+        client_.connect();
+    }
+
+    uint64_t echoes() const {
+        return echoes_;
+    }
+
+private:
+    TcpClient client_;
+    const std::string &payload_;
+    bool once_;
+    std::function<void()> on_close_;
+    uint64_t echoes_;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [handshakes] [connections] [seconds] [payload_size]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int handshakes = argc > 2 ? std::stoi(argv[2]) : 1000;
+    int connections = argc > 3 ? std::stoi(argv[3]) : 16;
+    int seconds = argc > 4 ? std::stoi(argv[4]) : 5;
+    std::string payload(argc > 5 ? std::stoul(argv[5]) : 4096, 'x');
+    Logger::setGLevel(Logger::WARN);
+
+    EventLoop loop;
+    InetAddress addr(port);
+    TlsContext context(TlsContext::Client);
+    //TcpClient需在loop中析构，进程即将退出，直接放弃这些连接
+    std::vector<BenchConnection *> conns;
+    Timestamp start = Timestamp::now();
+    int done = 0;
+
+    auto throughput = [&] {
+        start = Timestamp::now();
+        for (int i = 0; i < connections; ++i) {
+            conns.push_back(new BenchConnection(&loop, addr, &context, payload, false, nullptr));
+            conns.back()->connect();
+        }
+        loop.runAfter(seconds, [&] {
+            uint64_t echoes = 0;
+            for (size_t i = handshakes; i < conns.size(); ++i) {
+                echoes += conns[i]->echoes();
+            }
+            double elapsed = timeDifference(Timestamp::now(), start);
+            printf("%d connections, payload %zu: %.0f echoes/s, %.1f MiB/s each way\n", connections,
+                   payload.size(), static_cast<double>(echoes) / elapsed,
+                   static_cast<double>(echoes * payload.size()) / elapsed / 1024 / 1024);
+            printf("total handshakes %llu, resumed %llu, kTLS send %llu\n",
+                   static_cast<unsigned long long>(context.handshakes()),
+                   static_cast<unsigned long long>(context.resumedHandshakes()),
+                   static_cast<unsigned long long>(context.kernelTlsConnections()));
+            loop.quit();
+        });
+    };
+
+    std::function<void()> next = [&] {
+        if (done++ == handshakes) {
+            double elapsed = timeDifference(Timestamp::now(), start);
+            printf("%d sequential connections: %.0f handshakes/s, resumed %llu\n", handshakes,
+                   handshakes / elapsed, static_cast<unsigned long long>(context.resumedHandshakes()));
+            loop.queueInLoop(throughput);
+            return;
+        }
+        conns.push_back(new BenchConnection(&loop, addr, &context, payload, true, [&] { loop.queueInLoop(next); }));
+        conns.back()->connect();
+    };
+    loop.runInLoop(next);
+    loop.loop();
+}
@@ -0,0 +1,40 @@
+#include "net/EventLoop.h"
+#include "net/TcpServer.h"
+#include "net/TlsContext.h"
+#include <cstdio>
+
+/* TLS回显服务器，每5秒输出一次握手统计
+ * tls_echo_server port cert.pem key.pem [threads]
+ * 自签名证书：openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem -out cert.pem -subj /CN=localhost
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        printf("usage: %s port cert.pem key.pem [threads]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 4 ? std::stoi(argv[4]) : 0;
+    TlsContext context(TlsContext::Server);
+    if (!context.loadCertificate(argv[2], argv[3])) {
+        return 1;
+    }
+
+    EventLoop loop;
+    TcpServer server(&loop, InetAddress(port), "TlsEchoServer");
+    server.setTlsContext(&context);
+    server.setThreadNum(threads);
+    server.setMessageCallback([](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+        conn->send(buf);
+    });
+    uint64_t last_handshakes = 0;
+    loop.runEvery(5, [&] {
+        if (context.handshakes() != last_handshakes) {
+            last_handshakes = context.handshakes();
+            LOG_INFO << "handshakes " << last_handshakes << " resumed " << context.resumedHandshakes()
+                     << " kTLS " << context.kernelTlsConnections() << " connections " << server.numConnections();
+        }
+    });
+    server.start();
+    loop.loop();
+}
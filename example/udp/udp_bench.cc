@@ -0,0 +1,96 @@
+#include "net/EventLoop.h"
+#include "net/UdpSocket.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* 每个socket保持window个未返回的数据报，收到一个回显就再发一个；100ms内没有收到回显时认为窗口内的数据报已丢失，重新发满
+ * udp_bench port [sockets] [window] [seconds] [payload_size] [gro|gso|both]
+ * */
+
+class BenchSocket {
+public:
+    BenchSocket(EventLoop *loop, const InetAddress &server_addr, int window, const std::string &payload,
+                const char *offload)
+        : socket_(loop, InetAddress(0, "127.0.0.1")), server_addr_(server_addr), window_(window),
+          payload_(payload), echoes_(0), last_echoes_(0) {
+        socket_.enableGro(strcmp(offload, "gro") == 0 || strcmp(offload, "both") == 0);
+        socket_.enableGso(strcmp(offload, "gso") == 0 || strcmp(offload, "both") == 0);
+        socket_.setMessageCallback([this](UdpSocket *socket, const char *, size_t len, const InetAddress &, Timestamp) {
+            if (len == payload_.size()) {
+                ++echoes_;
+                socket->send(payload_.data(), payload_.size(), server_addr_);
+            }
+        });
+        socket_.start();
+    }
+
+    void refill() {
+        if (echoes_ == last_echoes_) {
+            for (int i = 0; i < window_; ++i) {
+                socket_.send(payload_.data(), payload_.size(), server_addr_);
+            }
+        }
+        last_echoes_ = echoes_;
+    }
+
+    uint64_t echoes() const {
+        return echoes_;
+    }
+
+    const UdpSocket &socket() const {
+        return socket_;
+    }
+
+private:
+    UdpSocket socket_;
+    InetAddress server_addr_;
+    int window_;
+    const std::string &payload_;
+    uint64_t echoes_;
+    uint64_t last_echoes_;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [sockets] [window] [seconds] [payload_size] [gro|gso|both]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int sockets = argc > 2 ? std::stoi(argv[2]) : 4;
+    int window = argc > 3 ? std::stoi(argv[3]) : 64;
+    int seconds = argc > 4 ? std::stoi(argv[4]) : 5;
+    std::string payload(argc > 5 ? std::stoul(argv[5]) : 64, 'x');
+    const char *offload = argc > 6 ? argv[6] : "";
+    Logger::setGLevel(Logger::WARN);
+
+    EventLoop loop;
+    InetAddress server_addr(port, "127.0.0.1");
+    std::vector<std::unique_ptr<BenchSocket>> bench_sockets;
+    for (int i = 0; i < sockets; ++i) {
+        bench_sockets.emplace_back(std::make_unique<BenchSocket>(&loop, server_addr, window, payload, offload));
+        bench_sockets.back()->refill();
+    }
+    loop.runEvery(0.1, [&] {
+        for (auto &bench_socket: bench_sockets) {
+            bench_socket->refill();
+        }
+    });
+    loop.runAfter(seconds, [&] {
+        uint64_t echoes = 0;
+        uint64_t sent = 0;
+        uint64_t dropped = 0;
+        for (auto &bench_socket: bench_sockets) {
+            echoes += bench_socket->echoes();
+            sent += bench_socket->socket().sentDatagrams();
+            dropped += bench_socket->socket().droppedDatagrams();
+        }
+        printf("%d sockets, window %d, payload %zu: %.0f echoes/s, sent %llu, dropped %llu\n", sockets, window,
+               payload.size(), static_cast<double>(echoes) / seconds, static_cast<unsigned long long>(sent),
+               static_cast<unsigned long long>(dropped));
+        loop.quit();
+    });
+    loop.loop();
+}
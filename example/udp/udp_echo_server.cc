@@ -0,0 +1,38 @@
+#include "net/EventLoop.h"
+#include "net/UdpServer.h"
+#include <cstdio>
+#include <cstring>
+
+/* UDP回显服务器，每个io线程一个SO_REUSEPORT socket，每5秒输出一次收发统计
+ * udp_echo_server port [threads] [gro|gso|both]
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [threads] [gro|gso|both]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    const char *offload = argc > 3 ? argv[3] : "";
+
+    EventLoop loop;
+    UdpServer server(&loop, InetAddress(port, "0.0.0.0"), "UdpEchoServer");
+    server.setThreadNum(threads);
+    server.enableGro(strcmp(offload, "gro") == 0 || strcmp(offload, "both") == 0);
+    server.enableGso(strcmp(offload, "gso") == 0 || strcmp(offload, "both") == 0);
+    server.setMessageCallback([](UdpSocket *socket, const char *data, size_t len, const InetAddress &peer, Timestamp) {
+        socket->send(data, len, peer);
+    });
+    uint64_t last_received = 0;
+    loop.runEvery(5, [&] {
+        uint64_t received = server.receivedDatagrams();
+        if (received != last_received) {
+            LOG_INFO << "received " << received << " (" << (received - last_received) / 5 << "/s) sent "
+                     << server.sentDatagrams() << " dropped " << server.droppedDatagrams();
+            last_received = received;
+        }
+    });
+    server.start();
+    loop.loop();
+}
@@ -0,0 +1,134 @@
+#include "net/EventLoop.h"
+#include "net/TcpClient.h"
+#include "net/websocket/WebSocketCodec.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* 每个连接先完成握手（用RFC 6455中的示例key校验Sec-WebSocket-Accept），
+ * 再保持in_flight条未返回的Binary消息，收到一条回显就再发一条；同时统计收到的广播
+ * ws_bench port [connections] [in_flight] [seconds] [payload_size]
+ * */
+
+uint64_t g_echoes = 0;
+uint64_t g_broadcasts = 0;
+uint64_t g_failures = 0;
+
+class BenchConnection {
+public:
+    BenchConnection(EventLoop *loop, const InetAddress &addr, int in_flight, const std::string &payload)
+        : client_(loop, addr, "ws_bench"), codec_(false), in_flight_(in_flight), payload_(payload), open_(false) {
+        client_.setConnectionCallback([this](const TcpConnectionPtr &conn) {
+            if (conn->connect()) {
+                conn->send(std::string("GET /ws HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\n"
+                                       "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                       "Sec-WebSocket-Version: 13\r\n\r\n"));
+            }
+        });
+        client_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) { onMessage(conn, buf); });
+    }
+
+    void connect() {
+        client_.connect();
+    }
+
+private:
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf) {
+        if (!open_) {
+            const char *begin = buf->peek();
+            const auto *end = static_cast<const char *>(memmem(begin, buf->readableBytes(), "\r\n\r\n", 4));
+            if (end == nullptr) {
+                return;
+            }
+            std::string_view response(begin, static_cast<size_t>(end - begin));
+            if (response.find("101") == std::string_view::npos ||
+                response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == std::string_view::npos) {
+                ++g_failures;
+                conn->forceClose();
+                return;
+            }
+            buf->retrieve(response.size() + 4);
+            open_ = true;
+            send(conn, in_flight_);
+        }
+        int echoes = 0;
+        while (true) {
+            WebSocketCodec::Result result = codec_.parse(buf);
+            if (result == WebSocketCodec::Incomplete) {
+                break;
+            }
+            if (result == WebSocketCodec::Error) {
+                ++g_failures;
+                conn->forceClose();
+                return;
+            }
+            if (result == WebSocketCodec::Message) {
+                if (codec_.opcode() == WebSocketCodec::Binary && codec_.payload() == payload_) {
+                    ++echoes;
+                } else if (codec_.opcode() == WebSocketCodec::Text) {
+                    ++g_broadcasts;
+                } else {
+                    ++g_failures;
+                }
+            }
+            codec_.consume(buf);
+        }
+        g_echoes += static_cast<uint64_t>(echoes);
+        send(conn, echoes);
+    }
+
+    void send(const TcpConnectionPtr &conn, int count) {
+        if (count == 0) {
+            return;
+        }
+        const uint8_t mask_key[4] = {0x12, 0x34, 0x56, 0x78};
+        Buffer output;
+        for (int i = 0; i < count; ++i) {
+            WebSocketCodec::appendFrame(&output, WebSocketCodec::Binary, payload_, mask_key);
+        }
+        conn->send(&output);
+    }
+
+    TcpClient client_;
+    WebSocketCodec codec_;
+    int in_flight_;
+    const std::string &payload_;
+    bool open_;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s port [connections] [in_flight] [seconds] [payload_size]\n", argv[0]);
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int connections = argc > 2 ? std::stoi(argv[2]) : 16;
+    int in_flight = argc > 3 ? std::stoi(argv[3]) : 16;
+    int seconds = argc > 4 ? std::stoi(argv[4]) : 5;
+    std::string payload(argc > 5 ? std::stoul(argv[5]) : 128, 'x');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    Logger::setGLevel(Logger::WARN);
+
+    EventLoop loop;
+    InetAddress addr(port);
+    std::vector<std::unique_ptr<BenchConnection>> conns;
+    for (int i = 0; i < connections; ++i) {
+        conns.emplace_back(std::make_unique<BenchConnection>(&loop, addr, in_flight, payload));
+        conns.back()->connect();
+    }
+    loop.runAfter(seconds, [&] {
+        printf("%d connections, in_flight %d, payload %zu: %.0f messages/s, %llu broadcasts, %llu failures\n",
+               connections, in_flight, payload.size(), static_cast<double>(g_echoes) / seconds,
+               static_cast<unsigned long long>(g_broadcasts), static_cast<unsigned long long>(g_failures));
+        loop.quit();
+    });
+    loop.loop();
+    //TcpClient需在loop中析构，进程即将退出，直接放弃这些连接
+    for (auto &conn: conns) {
+        conn.release();
+    }
+}
@@ -0,0 +1,35 @@
+#include "net/EventLoop.h"
+#include "net/websocket/WebSocketServer.h"
+#include <iostream>
+#include <string>
+
+/* ws_server port [threads] [broadcast_interval_ms]
+ * 只接受/ws上的升级请求，原样返回收到的消息
+ * broadcast_interval_ms大于0时定期向所有连接广播"tick N"
+ * */
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "usage:" << argv[0] << " port [threads] [broadcast_interval_ms]" << std::endl;
+        return 2;
+    }
+    auto port = static_cast<uint16_t>(std::stoul(argv[1]));
+    int threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    int interval_ms = argc > 3 ? std::stoi(argv[3]) : 0;
+    Logger::setGLevel(Logger::WARN);
+    EventLoop loop;
+    WebSocketServer server(&loop, InetAddress(port, "0.0.0.0"), "WebSocketServer");
+    server.setThreadNum(threads);
+    server.setAcceptCallback([](const HttpRequest &request) { return request.path() == "/ws"; });
+    server.setMessageCallback([](const TcpConnectionPtr &conn, std::string_view message, WebSocketCodec::Opcode opcode) {
+        WebSocketServer::send(conn, message, opcode);
+    });
+    server.start();
+    uint64_t ticks = 0;
+    if (interval_ms > 0) {
+        loop.runEvery(interval_ms / 1000.0, [&server, &ticks] {
+            server.broadcast(WebSocketServer::makeFrame("tick " + std::to_string(++ticks)));
+        });
+    }
+    loop.loop();
+}
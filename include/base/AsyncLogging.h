@@ -0,0 +1,91 @@
+#ifndef MYMUDUO_ASYNCLOGGING_H
+#define MYMUDUO_ASYNCLOGGING_H
+
+#include "LogStream.h"
+#include "noncopyable.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+/* 异步日志，前端线程把日志追加到当前缓冲，写满后交给后台线程写入滚动的LogFile
+ * 前端有current_、next_两块缓冲，后台有两块备用缓冲与之交换，正常情况下不分配内存
+ * 待写的缓冲最多max_buffers块，超出时按OverflowPolicy处理：
+ *   DropOldest 丢弃最早的一块待写缓冲（默认，保留最近的日志）
+ *   DropNewest 丢弃新来的日志
+ *   Block      等待后台写完，不丢日志但会阻塞io线程
+ * 丢弃的条数由dropped()返回，并在日志文件中记录
+ * 使用：Logger::setOutput(func)，在func中调用append
+ * */
+
+class AsyncLogging : private noncopyable {
+public:
+    enum OverflowPolicy {
+        DropOldest,
+        DropNewest,
+        Block,
+    };
+
+    AsyncLogging(std::string basename, off_t roll_size, int flush_interval = 3,
+                 size_t max_buffers = 16, OverflowPolicy policy = DropOldest);
+
+    ~AsyncLogging();
+
+    void append(const char *logline, size_t len);
+
+    void start();
+
+    void stop();
+
+    uint64_t dropped() const {
+        return dropped_;
+    }
+
+private:
+    //记录行数，丢弃时统计丢了多少条
+    class Buffer : public FixedBuffer<LargeBufferSize> {
+    public:
+        void append(const char *buf, size_t len) {
+            FixedBuffer::append(buf, len);
+            ++lines_;
+        }
+
+        size_t lines() const {
+            return lines_;
+        }
+
+        void reset() {
+            FixedBuffer::reset();
+            lines_ = 0;
+        }
+
+    private:
+        size_t lines_ = 0;
+    };
+
+    using BufferPtr = std::unique_ptr<Buffer>;
+    using BufferVector = std::vector<BufferPtr>;
+
+    void threadFunc();
+
+    const int flush_interval_;
+    const size_t max_buffers_;
+    const OverflowPolicy policy_;
+    const std::string basename_;
+    const off_t roll_size_;
+    std::atomic_bool running_;
+    std::atomic_uint64_t dropped_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;     //通知后台有写满的缓冲
+    std::condition_variable space_cond_;//Block时等待后台取走缓冲
+    BufferPtr current_;
+    BufferPtr next_;
+    BufferVector buffers_;
+};
+
+#endif//MYMUDUO_ASYNCLOGGING_H
@@ -0,0 +1,17 @@
+#ifndef MYMUDUO_BASE64_H
+#define MYMUDUO_BASE64_H
+
+#include <string>
+#include <string_view>
+
+/* 标准Base64（RFC 4648，带=填充） */
+
+class Base64 {
+public:
+    static std::string encode(std::string_view data);
+
+    /* 输入不合法时返回false */
+    static bool decode(std::string_view text, std::string *out);
+};
+
+#endif//MYMUDUO_BASE64_H
@@ -0,0 +1,259 @@
+#ifndef MYMUDUO_BINARYLOGGING_H
+#define MYMUDUO_BINARYLOGGING_H
+
+#include "CurrentThread.h"
+#include "Logging.h"
+#include "noncopyable.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+/* 二进制日志：调用线程只记录静态的调用点（格式串、文件、行号、级别）指针、时间和原始参数，
+ * 写入本线程的SPSC环形缓冲，由后台线程格式化后交给Logger的输出函数
+ * 格式串中每个{}依次替换为一个参数，参数可以是整数、枚举、浮点数、指针和字符串（最多保留255字节）
+ * 未start时在调用线程直接格式化输出，与LOG_*相同
+ * 环形缓冲满时丢弃并计数，调用线程不会阻塞；线程退出后它的环在后台线程取完剩余记录后释放
+ *   LOG_BIN_TRACE("update channel fd:{}", fd);
+ * */
+
+class BinaryLogging : private noncopyable {
+public:
+    struct Site {
+        const char *format;
+        Logger::SourceFile file;
+        int line;
+        Logger::LogLevel level;
+    };
+
+    /* 单生产者单消费者的字节环，记录8字节对齐且不跨越环尾 */
+    class Ring : private noncopyable {
+    public:
+        struct Header {
+            uint32_t size;//含头部，不含对齐填充；填充记录的tid为-1
+            int32_t tid;
+            const Site *site;
+            int64_t realtime_ns;
+        };
+
+        explicit Ring(size_t capacity);
+
+        static size_t alignedSize(size_t size) {
+            return (size + 7) & ~static_cast<size_t>(7);
+        }
+
+        char *reserve(size_t size);
+
+        void commit() {
+            head_.store(pending_, std::memory_order_release);
+        }
+
+        //在消费者线程中取出所有已提交的记录
+        template<typename Func>
+        void consume(Func &&func) {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            uint64_t head = head_.load(std::memory_order_acquire);
+            while (tail != head) {
+                auto *header = reinterpret_cast<const Header *>(data_.get() + (tail & mask_));
+                if (header->tid >= 0) {
+                    func(header);
+                }
+                tail += alignedSize(header->size);
+            }
+            tail_.store(tail, std::memory_order_release);
+        }
+
+        bool empty() const {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+        //生产者线程退出时调用，之后不再写入
+        void retire() {
+            retired_.store(true, std::memory_order_release);
+        }
+
+        bool retired() const {
+            return retired_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::unique_ptr<char[]> data_;
+        const uint64_t capacity_;
+        const uint64_t mask_;
+        uint64_t pending_;//生产者私有
+        alignas(64) std::atomic_uint64_t head_;
+        alignas(64) std::atomic_uint64_t tail_;
+        std::atomic_bool retired_;
+    };
+
+    /* 启动后台格式化线程，每个线程的环形缓冲ring_size字节（向上取2的幂），每flush_interval_ms毫秒收集一次 */
+    static void start(size_t ring_size = 1024 * 1024, int flush_interval_ms = 100);
+
+    /* 格式化剩余记录后停止，之后回到同步输出 */
+    static void stop();
+
+    static bool started() {
+        return started_.load(std::memory_order_acquire);
+    }
+
+    static uint64_t dropped() {
+        return dropped_;
+    }
+
+    template<typename... Args>
+    static void log(const Site &site, const Args &...args) {
+        Ring *ring = started() ? threadRing() : nullptr;
+        if (ring == nullptr) {//未start，或线程正在退出、环已交还
+            Logger logger(site.file, site.line, site.level);
+            formatArgs(logger.stream(), site.format, args...);
+            return;
+        }
+        size_t size = (sizeof(Ring::Header) + ... + argSize(args));
+        char *p = ring->reserve(size);
+        if (p == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto *header = reinterpret_cast<Ring::Header *>(p);
+        header->tid = CurrentThread::tid();
+        header->site = &site;
+        timespec ts{};
+        ::clock_gettime(CLOCK_REALTIME, &ts);
+        header->realtime_ns = ts.tv_sec * Timestamp::NanoSecondsPerSecond + ts.tv_nsec;
+        p += sizeof(Ring::Header);
+        ((p = encodeArg(p, args)), ...);
+        ring->commit();
+    }
+
+    //后台线程调用，按格式串还原一条记录
+    static void format(const Ring::Header *header);
+
+private:
+    enum ArgType : uint8_t {
+        Int,
+        UInt,
+        Double,
+        Pointer,
+        String,
+    };
+
+    static constexpr size_t MaxStringArg = 255;
+
+    template<typename T>
+    static constexpr bool isString() {
+        return std::is_convertible_v<const T &, std::string_view>;
+    }
+
+    template<typename T>
+    static std::string_view toStringView(const T &v) {
+        if constexpr (std::is_pointer_v<T>) {
+            if (v == nullptr) {
+                return "(null)";
+            }
+        }
+        return std::string_view(v);
+    }
+
+    template<typename T>
+    static size_t argSize(const T &v) {
+        if constexpr (isString<T>()) {
+            return 2 + std::min(toStringView(v).size(), MaxStringArg);
+        } else {
+            return 1 + 8;
+        }
+    }
+
+    template<typename T>
+    static char *encodeArg(char *p, const T &v) {
+        if constexpr (isString<T>()) {
+            std::string_view str = toStringView(v);
+            size_t len = std::min(str.size(), MaxStringArg);
+            *p++ = String;
+            *p++ = static_cast<char>(len);
+            memcpy(p, str.data(), len);
+            return p + len;
+        } else if constexpr (std::is_enum_v<T>) {
+            return encodeArg(p, static_cast<std::underlying_type_t<T>>(v));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            auto value = static_cast<int64_t>(v);
+            *p = Int;
+            memcpy(p + 1, &value, 8);
+            return p + 9;
+        } else if constexpr (std::is_integral_v<T>) {
+            auto value = static_cast<uint64_t>(v);
+            *p = UInt;
+            memcpy(p + 1, &value, 8);
+            return p + 9;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            auto value = static_cast<double>(v);
+            *p = Double;
+            memcpy(p + 1, &value, 8);
+            return p + 9;
+        } else {
+            static_assert(std::is_pointer_v<T>, "unsupported binary log argument");
+            auto value = reinterpret_cast<uintptr_t>(v);
+            *p = Pointer;
+            memcpy(p + 1, &value, 8);
+            return p + 9;
+        }
+    }
+
+    //返回下一个{}之后的位置，之前的内容写入stream
+    static const char *appendUntilPlaceholder(LogStream &stream, const char *format);
+
+    static void formatArgs(LogStream &stream, const char *format) {
+        stream << format;
+    }
+
+    template<typename T, typename... Rest>
+    static void formatArgs(LogStream &stream, const char *format, const T &v, const Rest &...rest) {
+        format = appendUntilPlaceholder(stream, format);
+        if constexpr (std::is_enum_v<T>) {
+            stream << static_cast<std::underlying_type_t<T>>(v);
+        } else if constexpr (isString<T>()) {
+            stream << toStringView(v);
+        } else if constexpr (std::is_pointer_v<T>) {
+            stream << static_cast<const void *>(v);
+        } else {
+            stream << v;
+        }
+        formatArgs(stream, format, rest...);
+    }
+
+    static Ring *threadRing() {
+        if (__builtin_expect(t_ring_ == nullptr, 0)) {
+            t_ring_ = registerThread();
+        }
+        return t_ring_;
+    }
+
+    //线程退出时交还t_ring_
+    struct ThreadRingOwner;
+
+    //线程退出后返回nullptr
+    static Ring *registerThread();
+
+    inline static std::atomic_bool started_{false};
+    inline static std::atomic_uint64_t dropped_{0};
+    inline static thread_local Ring *t_ring_ = nullptr;
+};
+
+#define LOG_BIN(level, format, ...)                                                                    \
+    do {                                                                                               \
+        if (Logger::compiledIn(Logger::level) && Logger::getGLevel() <= Logger::level) {               \
+            static constexpr BinaryLogging::Site mymuduo_site_{format, MYMUDUO_SOURCE_FILE, __LINE__, \
+                                                               Logger::level};                         \
+            BinaryLogging::log(mymuduo_site_, ##__VA_ARGS__);                                          \
+        }                                                                                              \
+    } while (0)
+
+#define LOG_BIN_TRACE(format, ...) LOG_BIN(TRACE, format, ##__VA_ARGS__)
+#define LOG_BIN_DEBUG(format, ...) LOG_BIN(DEBUG, format, ##__VA_ARGS__)
+#define LOG_BIN_INFO(format, ...) LOG_BIN(INFO, format, ##__VA_ARGS__)
+#define LOG_BIN_WARN(format, ...) LOG_BIN(WARN, format, ##__VA_ARGS__)
+#define LOG_BIN_ERROR(format, ...) LOG_BIN(ERROR, format, ##__VA_ARGS__)
+
+#endif//MYMUDUO_BINARYLOGGING_H
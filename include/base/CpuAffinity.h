@@ -0,0 +1,72 @@
+#ifndef MYMUDUO_CPUAFFINITY_H
+#define MYMUDUO_CPUAFFINITY_H
+
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+/* 线程绑核与NUMA内存策略
+ * 绑核后调用preferNode，该线程之后触发缺页的内存（glibc每线程arena中的Buffer等）优先分配在本节点
+ * */
+
+namespace CpuAffinity {
+    using CpuSet = std::vector<int>;
+
+    inline bool bindThisThread(const CpuSet &cpus) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu: cpus) {
+            CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    inline int currentCpu() {
+        return sched_getcpu();
+    }
+
+    inline int currentNode() {
+        unsigned cpu = 0, node = 0;
+        if (::syscall(SYS_getcpu, &cpu, &node, nullptr) < 0) {
+            return -1;
+        }
+        return static_cast<int>(node);
+    }
+
+    inline bool preferNode(int node) {
+        const int MpolPreferred = 1;
+        unsigned long mask = 0;
+        if (node < 0 || node >= static_cast<int>(sizeof(mask) * 8)) {//掩码只有一个unsigned long
+            return false;
+        }
+        mask = 1UL << node;
+        //内核get_nodes会先把maxnode减1，要让第63位生效需传65
+        return ::syscall(SYS_set_mempolicy, MpolPreferred, &mask, sizeof(mask) * 8 + 1) == 0;
+    }
+
+    inline int numCpus() {
+        return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    //解析 /sys/devices/system/node/nodeN/cpulist，如 "0-7,16-23"
+    inline CpuSet cpusOfNode(int node) {
+        CpuSet cpus;
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string range;
+        while (std::getline(in, range, ',')) {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+}// namespace CpuAffinity
+
+#endif//MYMUDUO_CPUAFFINITY_H
@@ -0,0 +1,48 @@
+#ifndef MYMUDUO_CURRENTTHREAD_H
+#define MYMUDUO_CURRENTTHREAD_H
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* 缓存本线程的tid及其字符串形式，日志每行都要用到 */
+
+namespace CurrentThread {
+    inline thread_local int t_cached_tid = 0;
+    inline thread_local char t_tid_string[16];
+    inline thread_local int t_tid_string_length = 0;
+
+    inline void cacheTid() {
+        t_cached_tid = static_cast<int>(::syscall(SYS_gettid));
+        int n = 0;
+        char tmp[16];
+        int tid = t_cached_tid;
+        do {
+            tmp[n++] = static_cast<char>('0' + tid % 10);
+            tid /= 10;
+        } while (tid > 0);
+        t_tid_string_length = n;
+        for (int i = 0; i < n; ++i) {
+            t_tid_string[i] = tmp[n - 1 - i];
+        }
+        t_tid_string[n] = '\0';
+    }
+
+    inline int tid() {
+        if (__builtin_expect(t_cached_tid == 0, 0)) {
+            cacheTid();
+        }
+        return t_cached_tid;
+    }
+
+    inline const char *tidString() {
+        tid();
+        return t_tid_string;
+    }
+
+    inline int tidStringLength() {
+        tid();
+        return t_tid_string_length;
+    }
+}// namespace CurrentThread
+
+#endif//MYMUDUO_CURRENTTHREAD_H
@@ -0,0 +1,86 @@
+#ifndef MYMUDUO_FLIGHTRECORDER_H
+#define MYMUDUO_FLIGHTRECORDER_H
+
+#include "TscClock.h"
+#include "noncopyable.h"
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <unistd.h>
+
+/* 飞行记录器：每个io线程一个定长环，记录最近的事件（poll返回、accept、读写字节数、定时器、functor）
+ * 只由本线程写入，每条记录一次rdtsc加几次store；环满后覆盖最旧的记录
+ * dump把所有线程的环按"距dump时刻多少毫秒"输出，只用write(2)，可以在信号处理函数中调用
+ * 输出时其他线程可能仍在写，个别记录可能不完整
+ * 使用：在创建EventLoop之前调用enable，EventLoop在构造时为本线程attachThread
+ *      LOG_FATAL、installSignalHandlers安装的致命信号以及dump_signal都会触发dump
+ * */
+
+class FlightRecorder : private noncopyable {
+public:
+    enum EventType : uint16_t {
+        PollReturn,//value为活跃channel数
+        Accept,    //fd为新连接
+        Read,      //value为读到的字节数
+        Write,     //value为写出的字节数
+        Close,
+        TimerFire, //value为到期的定时器数
+        Functors,  //value为执行的functor数
+        NumEventTypes,
+    };
+
+    struct Event {
+        uint64_t cycles;
+        int64_t value;
+        int32_t fd;
+        uint16_t type;
+    };
+
+    /* events_per_thread向上取2的幂 */
+    static void enable(size_t events_per_thread = 4096);
+
+    static bool enabled() {
+        return events_per_thread_.load(std::memory_order_relaxed) > 0;
+    }
+
+    /* 为当前线程分配记录环，name最多保留15字节；未enable、已分配或超过256个线程时什么也不做 */
+    static void attachThread(const char *name);
+
+    static void record(EventType type, int fd, int64_t value) {
+        Ring *ring = t_ring_;
+        if (ring == nullptr) {
+            return;
+        }
+        uint64_t index = ring->next.load(std::memory_order_relaxed);
+        Event &event = ring->events[index & ring->mask];
+        event.cycles = TscClock::cycles();
+        event.value = value;
+        event.fd = fd;
+        event.type = type;
+        ring->next.store(index + 1, std::memory_order_release);
+    }
+
+    /* 输出所有线程最近的事件，异步信号安全 */
+    static void dump(int fd = STDERR_FILENO);
+
+    /* 致命信号（SIGSEGV、SIGBUS、SIGFPE、SIGILL、SIGABRT）时dump后按默认方式处理
+     * dump_signal不为0时收到该信号只dump，用于排查卡住的loop
+     * */
+    static void installSignalHandlers(int dump_signal = SIGUSR2);
+
+private:
+    struct Ring {
+        Event *events;
+        uint64_t mask;
+        int tid;
+        char name[16];
+        std::atomic_uint64_t next;
+    };
+
+    inline static std::atomic_size_t events_per_thread_{0};
+    inline static thread_local Ring *t_ring_ = nullptr;
+};
+
+#define FLIGHT_RECORD(type, fd, value) FlightRecorder::record(FlightRecorder::type, fd, value)
+
+#endif//MYMUDUO_FLIGHTRECORDER_H
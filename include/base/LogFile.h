@@ -0,0 +1,45 @@
+#ifndef MYMUDUO_LOGFILE_H
+#define MYMUDUO_LOGFILE_H
+
+#include "noncopyable.h"
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <sys/types.h>
+
+/* 滚动日志文件，文件名为 basename.YYYYmmdd-HHMMSS.hostname.pid.log
+ * 写入超过roll_size字节或距上次滚动超过roll_interval秒时换新文件
+ * 不加锁，只在一个线程（AsyncLogging的后台线程）中使用
+ * */
+
+class LogFile : private noncopyable {
+public:
+    LogFile(std::string basename, off_t roll_size, int flush_interval = 3, int roll_interval = 24 * 3600);
+
+    ~LogFile();
+
+    void append(const char *logline, size_t len);
+
+    void flush();
+
+    bool rollFile();
+
+private:
+    static const int CheckTimeEveryN = 1024;
+
+    std::string logFileName(time_t now) const;
+
+    const std::string basename_;
+    const off_t roll_size_;
+    const int flush_interval_;
+    const int roll_interval_;
+    FILE *fp_;
+    off_t written_bytes_;
+    int count_;
+    time_t start_of_period_;
+    time_t last_roll_;
+    time_t last_flush_;
+    char buffer_[64 * 1024];
+};
+
+#endif//MYMUDUO_LOGFILE_H
@@ -0,0 +1,169 @@
+#ifndef MYMUDUO_LOGSTREAM_H
+#define MYMUDUO_LOGSTREAM_H
+
+#include "noncopyable.h"
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/* 定长缓冲，写满后丢弃多余的内容，不分配内存 */
+
+template<size_t SIZE>
+class FixedBuffer : private noncopyable {
+public:
+    FixedBuffer() : cur_(data_) {}
+
+    void append(const char *buf, size_t len) {
+        if (avail() > len) {
+            memcpy(cur_, buf, len);
+            cur_ += len;
+        }
+    }
+
+    const char *data() const {
+        return data_;
+    }
+
+    size_t length() const {
+        return static_cast<size_t>(cur_ - data_);
+    }
+
+    char *current() {
+        return cur_;
+    }
+
+    size_t avail() const {
+        return static_cast<size_t>(end() - cur_);
+    }
+
+    void add(size_t len) {
+        cur_ += len;
+    }
+
+    void reset() {
+        cur_ = data_;
+    }
+
+    std::string toString() const {
+        return std::string(data_, length());
+    }
+
+private:
+    const char *end() const {
+        return data_ + sizeof(data_);
+    }
+
+    char data_[SIZE];
+    char *cur_;
+};
+
+static constexpr size_t SmallBufferSize = 4000;
+static constexpr size_t LargeBufferSize = 4000 * 1000;
+
+/* 替代stringstream，整数和浮点数手写格式化，直接写入FixedBuffer */
+
+class LogStream : private noncopyable {
+public:
+    using Buffer = FixedBuffer<SmallBufferSize>;
+
+    LogStream &operator<<(bool v) {
+        buffer_.append(v ? "1" : "0", 1);
+        return *this;
+    }
+
+    LogStream &operator<<(short v) {
+        return *this << static_cast<int>(v);
+    }
+
+    LogStream &operator<<(unsigned short v) {
+        return *this << static_cast<unsigned int>(v);
+    }
+
+    LogStream &operator<<(int v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(unsigned int v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(long v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(unsigned long v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(long long v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(unsigned long long v) {
+        formatInteger(v);
+        return *this;
+    }
+
+    LogStream &operator<<(const void *p);
+
+    LogStream &operator<<(float v) {
+        return *this << static_cast<double>(v);
+    }
+
+    LogStream &operator<<(double v);
+
+    LogStream &operator<<(char v) {
+        buffer_.append(&v, 1);
+        return *this;
+    }
+
+    LogStream &operator<<(const char *str) {
+        if (str) {
+            buffer_.append(str, strlen(str));
+        } else {
+            buffer_.append("(null)", 6);
+        }
+        return *this;
+    }
+
+    LogStream &operator<<(const unsigned char *str) {
+        return *this << reinterpret_cast<const char *>(str);
+    }
+
+    LogStream &operator<<(const std::string &v) {
+        buffer_.append(v.data(), v.size());
+        return *this;
+    }
+
+    LogStream &operator<<(std::string_view v) {
+        buffer_.append(v.data(), v.size());
+        return *this;
+    }
+
+    void append(const char *data, size_t len) {
+        buffer_.append(data, len);
+    }
+
+    const Buffer &buffer() const {
+        return buffer_;
+    }
+
+    void resetBuffer() {
+        buffer_.reset();
+    }
+
+private:
+    static constexpr size_t MaxNumericSize = 48;
+
+    template<typename T>
+    void formatInteger(T v);
+
+    Buffer buffer_;
+};
+
+#endif//MYMUDUO_LOGSTREAM_H
@@ -1,46 +1,70 @@
 #ifndef MYMUDUO_LOGGING_H
 #define MYMUDUO_LOGGING_H
 
+#include "LogStream.h"
 #include "Timestamp.h"
-#include <iostream>
-#include <sstream>
-#include <thread>
+#include <cstddef>
+#include <type_traits>
 #include <unistd.h>
 
-/* 在析构函数中输出，可保证输出不乱序 */
+/* 在析构函数中输出，可保证输出不乱序
+ * 一行日志在栈上的LogStream中格式化，不分配内存；时间前缀每线程每秒只格式化一次
+ * 默认同步写到标准输出，可用setOutput换成AsyncLogging等后端
+ * 编译时定义MYMUDUO_MIN_LOG_LEVEL（0-5对应TRACE-FATAL）后，低于该级别的日志语句条件恒为假，整条被编译器删除
+ * */
+
+#ifndef MYMUDUO_MIN_LOG_LEVEL
+#define MYMUDUO_MIN_LOG_LEVEL 0
+#endif
 
 class Logger {
 public:
+    using OutputFunc = void (*)(const char *msg, size_t len);
+    using FlushFunc = void (*)();
+
     enum LogLevel {
         TRACE,
         DEBUG,
         INFO,
         WARN,
         ERROR,
-        FATAL
+        FATAL,
+        NumLogLevels,
     };
-    Logger(const char *source_file, int line, LogLevel level)
-        : source_file_(source_file), line_(line), time_(Timestamp::now()), level_(level) {
-        stream_ << time_.toString() << " " << std::this_thread::get_id() << " " << toString(level_) << " ";
-    }
 
-    template<typename T>
-    Logger &operator<<(T &&t) {
-        stream_ << std::forward<T>(t);
-        return *this;
-    }
+    //编译期从__FILE__中取出文件名
+    class SourceFile {
+    public:
+        constexpr SourceFile(const char *path, size_t offset, size_t len)
+            : data_(path + offset), size_(len - offset) {}
+
+        const char *data_;
+        size_t size_;
+    };
 
-    template<typename T>
-    Logger &operator<<(const T &t) {
-        stream_ << t;
-        return *this;
+    static constexpr size_t basenameOffset(const char *path) {
+        size_t offset = 0;
+        for (size_t i = 0; path[i] != '\0'; ++i) {
+            if (path[i] == '/') {
+                offset = i + 1;
+            }
+        }
+        return offset;
     }
 
+    Logger(SourceFile file, int line, LogLevel level);
+
+    //使用给定的时间(CLOCK_REALTIME纳秒)和线程id，供BinaryLogging的后台线程格式化
+    Logger(SourceFile file, int line, LogLevel level, int64_t realtime_ns, int tid);
+
+    ~Logger();
+
+    LogStream &stream() {
+        return stream_;
+    }
 
-    ~Logger() {
-        stream_ << " " << source_file_ << ":" << line_ << "\n";
-        std::string buf = stream_.str();
-        ::write(1, buf.c_str(), buf.size());
+    static constexpr bool compiledIn(LogLevel level) {
+        return level >= MYMUDUO_MIN_LOG_LEVEL;
     }
 
     static LogLevel getGLevel() {
@@ -51,41 +75,49 @@ public:
         g_level_ = level;
     }
 
+    static void setOutput(OutputFunc out) {
+        g_output_ = out;
+    }
+
+    static void setFlush(FlushFunc flush) {
+        g_flush_ = flush;
+    }
+
+    static void output(const char *msg, size_t len) {
+        g_output_(msg, len);
+    }
+
 private:
-    static const char *toString(LogLevel level) {
-        switch (level) {
-            case LogLevel::TRACE:
-                return "TRACE";
-            case LogLevel::DEBUG:
-                return "DEBUG";
-            case LogLevel::INFO:
-                return "INFO";
-            case LogLevel::WARN:
-                return "WARN";
-            case LogLevel::ERROR:
-                return "ERROR";
-            case LogLevel::FATAL:
-                return "FATAL";
-        }
+    static void defaultOutput(const char *msg, size_t len) {
+        ::write(1, msg, len);
     }
-    std::string source_file_;
+
+    static void defaultFlush() {}
+
+    void formatTime(const timespec &ts);
+
+    LogStream stream_;
+    SourceFile file_;
     int line_;
     LogLevel level_;
-    Timestamp time_;
-    std::stringstream stream_;
     inline static LogLevel g_level_ = INFO;
+    inline static OutputFunc g_output_ = defaultOutput;
+    inline static FlushFunc g_flush_ = defaultFlush;
 };
 
+#define MYMUDUO_SOURCE_FILE \
+    Logger::SourceFile(__FILE__, std::integral_constant<size_t, Logger::basenameOffset(__FILE__)>::value, sizeof(__FILE__) - 1)
+
 #define LOG_INFO \
-    if (Logger::getGLevel() <= Logger::LogLevel::INFO) Logger(__FILE__, __LINE__, Logger::INFO)
+    if (Logger::compiledIn(Logger::INFO) && Logger::getGLevel() <= Logger::INFO) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::INFO).stream()
 #define LOG_TRACE \
-    if (Logger::getGLevel() <= Logger::LogLevel::TRACE) Logger(__FILE__, __LINE__, Logger::TRACE)
+    if (Logger::compiledIn(Logger::TRACE) && Logger::getGLevel() <= Logger::TRACE) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::TRACE).stream()
 #define LOG_DEBUG \
-    if (Logger::getGLevel() <= Logger::LogLevel::DEBUG) Logger(__FILE__, __LINE__, Logger::DEBUG)
+    if (Logger::compiledIn(Logger::DEBUG) && Logger::getGLevel() <= Logger::DEBUG) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::DEBUG).stream()
 #define LOG_WARN \
-    if (Logger::getGLevel() <= Logger::LogLevel::WARN) Logger(__FILE__, __LINE__, Logger::WARN)
+    if (Logger::compiledIn(Logger::WARN) && Logger::getGLevel() <= Logger::WARN) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::WARN).stream()
 #define LOG_ERROR \
-    if (Logger::getGLevel() <= Logger::LogLevel::ERROR) Logger(__FILE__, __LINE__, Logger::ERROR)
+    if (Logger::compiledIn(Logger::ERROR) && Logger::getGLevel() <= Logger::ERROR) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::ERROR).stream()
 #define LOG_FATAL \
-    if (Logger::getGLevel() <= Logger::LogLevel::FATAL) Logger(__FILE__, __LINE__, Logger::FATAL)
+    if (Logger::compiledIn(Logger::FATAL) && Logger::getGLevel() <= Logger::FATAL) Logger(MYMUDUO_SOURCE_FILE, __LINE__, Logger::FATAL).stream()
 #endif//MYMUDUO_LOGGING_H
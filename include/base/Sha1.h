@@ -0,0 +1,37 @@
+#ifndef MYMUDUO_SHA1_H
+#define MYMUDUO_SHA1_H
+
+#include "copyable.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/* SHA-1摘要，只用于WebSocket握手等协议要求的场合，不应用于安全用途 */
+
+class Sha1 : public copyable {
+public:
+    using Digest = std::array<uint8_t, 20>;
+
+    Sha1();
+
+    void update(const void *data, size_t len);
+
+    Digest final();
+
+    static Digest digest(std::string_view data) {
+        Sha1 sha1;
+        sha1.update(data.data(), data.size());
+        return sha1.final();
+    }
+
+private:
+    void processBlock(const uint8_t *block);
+
+    uint32_t state_[5];
+    uint64_t length_;//已输入的字节数
+    uint8_t block_[64];
+    size_t block_len_;
+};
+
+#endif//MYMUDUO_SHA1_H
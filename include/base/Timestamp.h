@@ -2,10 +2,16 @@
 #define MYMUDUO_TIMESTAMP_H
 
 #include "copyable.h"
-#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
 #include <memory>
 #include <string>
 
+/* CLOCK_MONOTONIC上的纳秒时间，不受系统时间调整影响，可直接用于timerfd和计算时间差
+ * toString时换算成墙上时间
+ * */
+
 class Timestamp : public copyable {
 public:
     friend bool operator<(const Timestamp &, const Timestamp &);
@@ -13,50 +19,73 @@ public:
 
     using TimestampPtr = std::shared_ptr<Timestamp>;
 
-    explicit Timestamp() : micro_seconds_since_epoch_(0) {}
+    static constexpr int64_t NanoSecondsPerSecond = 1000 * 1000 * 1000;
+
+    explicit Timestamp() : nano_seconds_(0) {}
 
-    explicit Timestamp(time_t micro_seconds_since_epoch) : micro_seconds_since_epoch_(micro_seconds_since_epoch) {}
+    explicit Timestamp(int64_t nano_seconds) : nano_seconds_(nano_seconds) {}
 
     static Timestamp now() {
-        return Timestamp(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        timespec ts{};
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return Timestamp(ts.tv_sec * NanoSecondsPerSecond + ts.tv_nsec);
+    }
+
+    bool valid() const {
+        return nano_seconds_ > 0;
     }
 
     std::string toString() const {
-        tm *ptm = localtime(&micro_seconds_since_epoch_);
-        char str[128] = {0};
-        sprintf(str, "%4d-%02d-%02d %02d:%02d:%02d",
-                ptm->tm_year + 1900,
-                ptm->tm_mon,
-                ptm->tm_mday,
-                ptm->tm_hour,
-                ptm->tm_min,
-                ptm->tm_sec);
+        timespec mono{}, real{};//用当前两个时钟的差换算
+        ::clock_gettime(CLOCK_MONOTONIC, &mono);
+        ::clock_gettime(CLOCK_REALTIME, &real);
+        int64_t offset = (real.tv_sec - mono.tv_sec) * NanoSecondsPerSecond + (real.tv_nsec - mono.tv_nsec);
+        time_t seconds = static_cast<time_t>((nano_seconds_ + offset) / NanoSecondsPerSecond);
+        tm tm_time{};
+        localtime_r(&seconds, &tm_time);
+        char str[72] = {0};//按每个字段都是最长的int计算，避免截断
+        snprintf(str, sizeof(str), "%4d-%02d-%02d %02d:%02d:%02d",
+                 tm_time.tm_year + 1900,
+                 tm_time.tm_mon + 1,
+                 tm_time.tm_mday,
+                 tm_time.tm_hour,
+                 tm_time.tm_min,
+                 tm_time.tm_sec);
         return {str};
     }
 
     Timestamp operator+(double seconds) const {
-        auto delta = static_cast<int64_t>(seconds * 1000);
-        return Timestamp(micro_seconds_since_epoch_ + delta);
+        auto delta = static_cast<int64_t>(seconds * NanoSecondsPerSecond);
+        return Timestamp(nano_seconds_ + delta);
     }
 
-    time_t microSecondsSinceEpoch() const {
-        return micro_seconds_since_epoch_;
+    int64_t nanoSeconds() const {
+        return nano_seconds_;
+    }
+
+    int64_t microSeconds() const {
+        return nano_seconds_ / 1000;
     }
 
     void swap(Timestamp &other) {
-        std::swap(micro_seconds_since_epoch_, other.micro_seconds_since_epoch_);
+        std::swap(nano_seconds_, other.nano_seconds_);
     }
 
 private:
-    time_t micro_seconds_since_epoch_;
+    int64_t nano_seconds_;
 };
 
 inline bool operator<(const Timestamp &lhs, const Timestamp &rhs) {
-    return lhs.micro_seconds_since_epoch_ < rhs.micro_seconds_since_epoch_;
+    return lhs.nano_seconds_ < rhs.nano_seconds_;
 }
 
 inline bool operator==(const Timestamp &lhs, const Timestamp &rhs) {
-    return lhs.micro_seconds_since_epoch_ == rhs.micro_seconds_since_epoch_;
+    return lhs.nano_seconds_ == rhs.nano_seconds_;
+}
+
+/* high - low，单位秒 */
+inline double timeDifference(Timestamp high, Timestamp low) {
+    return static_cast<double>(high.nanoSeconds() - low.nanoSeconds()) / Timestamp::NanoSecondsPerSecond;
 }
 
 #endif//MYMUDUO_TIMESTAMP_H
@@ -0,0 +1,74 @@
+#ifndef MYMUDUO_TSCCLOCK_H
+#define MYMUDUO_TSCCLOCK_H
+
+#include "Timestamp.h"
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+/* 基于TSC的计时，读一次约几纳秒，用于benchmark中的高频计时
+ * 只在CPU支持invariant TSC时使用，否则退回CLOCK_MONOTONIC
+ * 第一次使用时用CLOCK_MONOTONIC校准约10ms
+ * */
+
+class TscClock {
+public:
+    static bool available() {
+        return instance().invariant_;
+    }
+
+    static uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (instance().invariant_) {
+            return __rdtsc();
+        }
+#endif
+        return static_cast<uint64_t>(Timestamp::now().nanoSeconds());
+    }
+
+    static int64_t toNanos(uint64_t cycles) {
+        return static_cast<int64_t>(static_cast<double>(cycles) * instance().nanos_per_cycle_);
+    }
+
+    /* 与Timestamp同一时间轴的纳秒数 */
+    static int64_t nanos() {
+        const TscClock &clock = instance();
+        return clock.base_nanos_ + toNanos(cycles() - clock.base_cycles_);
+    }
+
+private:
+    TscClock() : invariant_(false), nanos_per_cycle_(1.0), base_cycles_(0), base_nanos_(0) {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8))) {
+            invariant_ = true;
+            Timestamp start = Timestamp::now();
+            uint64_t start_cycles = __rdtsc();
+            timespec ts{0, 10 * 1000 * 1000};
+            ::nanosleep(&ts, nullptr);
+            Timestamp end = Timestamp::now();
+            uint64_t end_cycles = __rdtsc();
+            nanos_per_cycle_ = static_cast<double>(end.nanoSeconds() - start.nanoSeconds()) /
+                               static_cast<double>(end_cycles - start_cycles);
+            base_cycles_ = end_cycles;
+            base_nanos_ = end.nanoSeconds();
+        }
+#endif
+    }
+
+    static const TscClock &instance() {
+        static TscClock clock;
+        return clock;
+    }
+
+    bool invariant_;
+    double nanos_per_cycle_;
+    uint64_t base_cycles_;
+    int64_t base_nanos_;
+};
+
+#endif//MYMUDUO_TSCCLOCK_H
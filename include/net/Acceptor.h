@@ -5,6 +5,7 @@
 #include "Socket.h"
 #include "Channel.h"
 #include <functional>
+#include <vector>
 
 class InetAddress;
 class EventLoop;
@@ -12,32 +13,71 @@ class EventLoop;
 /* listen和accept
  * 其中用Channel监听accept_socket的read事件，
  * 若有read事件说明有连接来了，则用accept接受信息，并生成与之连接的fd，再通过newConnectionCallback回调处理
+ * 每次read事件最多accept accept_budget_个连接，设置了NewConnectionsCallback时整批交给回调
+ * fd耗尽(EMFILE)时关闭预留的idle_fd_腾出位置，accept后立即关闭，避免listen socket一直可读导致loop空转
  * */
 
 class Acceptor : private noncopyable {
 public:
+    struct AcceptedConnection {
+        int fd;
+        InetAddress peer_addr;
+    };
     using NewConnectionCallback = std::function<void(int, const InetAddress &)>;
+    using NewConnectionsCallback = std::function<void(std::vector<AcceptedConnection> &)>;
+    static const int DefaultAcceptBudget = 64;
+
     Acceptor(EventLoop *loop, const InetAddress &listen_addr, bool reuse_port);
 
+    /* 使用已bind的listen fd，exclusive为true时以EPOLLEXCLUSIVE监听 */
+    Acceptor(EventLoop *loop, int listen_fd, bool exclusive);
+
     ~Acceptor();
 
     void setNewConnectionCallback(const NewConnectionCallback &cb) {
         new_connection_callback_ = cb;
     }
 
+    void setNewConnectionsCallback(const NewConnectionsCallback &cb) {
+        new_connections_callback_ = cb;
+    }
+
+    void setAcceptBudget(int budget) {
+        accept_budget_ = budget > 0 ? budget : 1;
+    }
+
     bool listening() const {
         return listening_;
     }
 
     void listen();
 
+    void setIncomingCpu(int cpu) {
+        accept_socket_.setIncomingCpu(cpu);
+    }
+
+    EventLoop *getLoop() const {
+        return loop_;
+    }
+
+    int listenFd() const {
+        return accept_socket_.getFd();
+    }
+
 private:
     void handleRead();
+
+    bool rejectWithIdleFd();
+
     EventLoop *loop_;
     Socket accept_socket_;
     Channel accept_channel_;
     NewConnectionCallback new_connection_callback_;
+    NewConnectionsCallback new_connections_callback_;
     bool listening_;
+    int accept_budget_;
+    int idle_fd_;
+    std::vector<AcceptedConnection> batch_;
 };
 
 #endif//MYMUDUO_ACCEPTOR_H
@@ -5,7 +5,9 @@
 #include "SocketOps.h"
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <endian.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,13 +17,29 @@ inline constexpr char CRLF[] = "\r\n";
 class Buffer : public noncopyable {
 public:
     using ptr = std::shared_ptr<Buffer>;
-    static const size_t cheap_prepend = 8;
+    static const size_t cheap_prepend = 16;//放得下最长的WebSocket帧头（14字节）
     static const size_t initial_size = 1024;
     explicit Buffer(size_t size = initial_size)
         : buffer_(initial_size + cheap_prepend),
           read_index_(cheap_prepend),
           writer_index_(cheap_prepend) {}
 
+    /* 使用回收的存储，容量足够时不再分配 */
+    explicit Buffer(std::vector<char> storage)
+        : buffer_(std::move(storage)),
+          read_index_(cheap_prepend),
+          writer_index_(cheap_prepend) {
+        if (buffer_.size() < initial_size + cheap_prepend) {
+            buffer_.resize(initial_size + cheap_prepend);
+        }
+    }
+
+    /* 交出底层存储供回收，只应在Buffer不再使用时调用 */
+    std::vector<char> releaseStorage() {
+        retrieveAll();
+        return std::move(buffer_);
+    }
+
     size_t writeableBytes() const {
         return buffer_.size() - writer_index_;
     }
@@ -51,6 +69,11 @@ public:
         return begin() + read_index_;
     }
 
+    /* 可写的可读区起点，供原地修改数据（如chunked拼接、WebSocket去掩码） */
+    char *beginRead() {
+        return begin() + read_index_;
+    }
+
     const char *findCRLF() const {
         const char *crlf = std::search(peek(), beginWrite(), CRLF, CRLF + 2);
         return crlf == beginWrite() ? nullptr : crlf;
@@ -67,9 +90,7 @@ public:
     }
 
     void append(const char *str, size_t len) {
-        if (writeableBytes() < len) {
-            makeSpace(len);
-        }
+        ensureWritableBytes(len);
         std::copy(str, str + len, beginWrite());
         writer_index_ += len;
     }
@@ -82,6 +103,109 @@ public:
         append(str.c_str(), str.length());
     }
 
+    /* 整数均按网络字节序读写 */
+    void appendInt64(int64_t x) {
+        uint64_t be = htobe64(static_cast<uint64_t>(x));
+        append(&be, sizeof(be));
+    }
+
+    void appendInt32(int32_t x) {
+        uint32_t be = htobe32(static_cast<uint32_t>(x));
+        append(&be, sizeof(be));
+    }
+
+    void appendInt16(int16_t x) {
+        uint16_t be = htobe16(static_cast<uint16_t>(x));
+        append(&be, sizeof(be));
+    }
+
+    void appendInt8(int8_t x) {
+        append(&x, sizeof(x));
+    }
+
+    /* 调用前需保证readableBytes()足够 */
+    int64_t peekInt64() const {
+        uint64_t be;
+        memcpy(&be, peek(), sizeof(be));
+        return static_cast<int64_t>(be64toh(be));
+    }
+
+    int32_t peekInt32() const {
+        uint32_t be;
+        memcpy(&be, peek(), sizeof(be));
+        return static_cast<int32_t>(be32toh(be));
+    }
+
+    int16_t peekInt16() const {
+        uint16_t be;
+        memcpy(&be, peek(), sizeof(be));
+        return static_cast<int16_t>(be16toh(be));
+    }
+
+    int8_t peekInt8() const {
+        return static_cast<int8_t>(*peek());
+    }
+
+    int64_t readInt64() {
+        int64_t x = peekInt64();
+        retrieve(sizeof(x));
+        return x;
+    }
+
+    int32_t readInt32() {
+        int32_t x = peekInt32();
+        retrieve(sizeof(x));
+        return x;
+    }
+
+    int16_t readInt16() {
+        int16_t x = peekInt16();
+        retrieve(sizeof(x));
+        return x;
+    }
+
+    int8_t readInt8() {
+        int8_t x = peekInt8();
+        retrieve(sizeof(x));
+        return x;
+    }
+
+    /* 写到可读区之前，不移动数据；调用前需保证prependableBytes()足够 */
+    void prepend(const void *data, size_t len) {
+        read_index_ -= len;
+        memcpy(begin() + read_index_, data, len);
+    }
+
+    void prependInt64(int64_t x) {
+        uint64_t be = htobe64(static_cast<uint64_t>(x));
+        prepend(&be, sizeof(be));
+    }
+
+    void prependInt32(int32_t x) {
+        uint32_t be = htobe32(static_cast<uint32_t>(x));
+        prepend(&be, sizeof(be));
+    }
+
+    void prependInt16(int16_t x) {
+        uint16_t be = htobe16(static_cast<uint16_t>(x));
+        prepend(&be, sizeof(be));
+    }
+
+    void prependInt8(int8_t x) {
+        prepend(&x, sizeof(x));
+    }
+
+    /* 直接在beginWrite()处写入时先预留空间，写完后调用hasWritten */
+    void ensureWritableBytes(size_t len) {
+        if (writeableBytes() < len) {
+            makeSpace(len);
+        }
+    }
+
+    void hasWritten(size_t len) {
+        writer_index_ += len;
+    }
+
 
     char *beginWrite() {
         return begin() + writer_index_;
@@ -1,7 +1,7 @@
 #ifndef MYMUDUO_CHANNEL_H
 #define MYMUDUO_CHANNEL_H
 
-#include "base/Logging.h"
+#include "base/BinaryLogging.h"
 #include "base/Timestamp.h"
 #include "base/noncopyable.h"
 #include <functional>
@@ -24,7 +24,7 @@ public:
 
     Channel(EventLoop *loop, int fd) : loop_(loop), fd_(fd),
                                        events_(0), revents_(0),
-                                       index_(-1), tied_(false) {}
+                                       index_(-1), tied_(false), exclusive_(false) {}
 
     void setReadCallback(ReadEventCallback cb) {
         this->read_callback_ = std::move(cb);
@@ -84,6 +84,15 @@ public:
         return this->events_;
     }
 
+    /* 以EPOLLEXCLUSIVE加入epoll，多个loop监听同一个fd时只唤醒其中一个 */
+    void setExclusive(bool on) {
+        this->exclusive_ = on;
+    }
+
+    bool exclusive() const {
+        return this->exclusive_;
+    }
+
     int fd() const {
         return this->fd_;
     }
@@ -110,7 +119,7 @@ public:
 
 private:
     void handleEventWithGuard(Timestamp receive_time) {
-        LOG_TRACE << "channel handleEvent revents:" << revents();
+        LOG_BIN_TRACE("channel handleEvent fd:{} revents:{}", fd_, revents());
         if ((this->revents_ & EPOLLHUP) && !(this->revents_ & EPOLLIN)) {
             if (this->close_callback_) {
                 this->close_callback_();
@@ -143,6 +152,7 @@ private:
     int index_;
     std::weak_ptr<void> tie_;
     bool tied_;
+    bool exclusive_;
 
     ReadEventCallback read_callback_;
     EventCallback write_callback_;
@@ -0,0 +1,160 @@
+#ifndef MYMUDUO_COMPUTETHREADPOOL_H
+#define MYMUDUO_COMPUTETHREADPOOL_H
+
+#include "base/noncopyable.h"
+#include "net/EventLoop.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/* 计算线程池，每个worker一个任务双端队列
+ * worker从自己队列尾部取任务，空闲时从其他worker队列头部窃取
+ * offload把job放到池中执行，完成后在发起的EventLoop中调用done；job抛出异常时改为调用error
+ * */
+
+class ComputeThreadPool : private noncopyable {
+public:
+    using Task = std::function<void()>;
+    using ErrorCallback = std::function<void(const std::string &)>;
+
+    explicit ComputeThreadPool(int num_threads, std::string name = "ComputeThreadPool");
+
+    ~ComputeThreadPool();
+
+    void start();
+
+    void stop();
+
+    void submit(Task task);
+
+    /* job在池中执行，其返回值（需可拷贝）在loop线程中传给done
+     * job抛出异常时在loop线程中以异常信息调用error（可以为空），done不再调用
+     * */
+    template<typename Job, typename Done>
+    void offload(EventLoop *loop, Job job, Done done, ErrorCallback error = ErrorCallback()) {
+        submit([this, loop, job = std::move(job), done = std::move(done), error = std::move(error)]() mutable {
+            std::string what;
+            try {
+                if constexpr (std::is_void_v<std::invoke_result_t<Job &>>) {
+                    job();
+                    loop->queueInLoop(std::move(done));
+                } else {
+                    loop->queueInLoop([done = std::move(done), result = job()]() mutable { done(std::move(result)); });
+                }
+                return;
+            } catch (const std::exception &e) {
+                what = e.what();
+            } catch (...) {
+                what = "unknown exception";
+            }
+            logJobException(what);
+            loop->queueInLoop([error = std::move(error), what = std::move(what)] {
+                if (error) {
+                    error(what);
+                }
+            });
+        });
+    }
+
+    const std::string &name() const {
+        return name_;
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void workerFunc(size_t index);
+
+    void logJobException(const std::string &what) const;
+
+    bool popLocal(size_t index, Task *task);
+
+    bool steal(size_t index, Task *task);
+
+    std::string name_;
+    int num_threads_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic_bool running_;
+    std::atomic_size_t next_;
+    std::atomic_int64_t pending_;
+    std::atomic_int idle_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cond_;
+    inline static thread_local ComputeThreadPool *t_pool_ = nullptr;
+    inline static thread_local size_t t_index_ = 0;
+};
+
+/* 保证同一连接上offload的结果按提交顺序完成
+ * 只能在loop线程中使用，通常作为TcpConnection的context保存
+ * */
+
+class ComputeSequencer : private noncopyable, public std::enable_shared_from_this<ComputeSequencer> {
+public:
+    explicit ComputeSequencer(EventLoop *loop) : loop_(loop), next_seq_(0), next_done_(0) {}
+
+    /* job抛出异常时按顺序调用error，之后的结果不受影响 */
+    template<typename Job, typename Done>
+    void offload(ComputeThreadPool *pool, Job job, Done done,
+                 ComputeThreadPool::ErrorCallback error = ComputeThreadPool::ErrorCallback()) {
+        uint64_t seq = next_seq_++;
+        auto self = shared_from_this();
+        auto on_error = [self, seq, error = std::move(error)](const std::string &what) {
+            self->complete(seq, [error, what] {
+                if (error) {
+                    error(what);
+                }
+            });
+        };
+        if constexpr (std::is_void_v<std::invoke_result_t<Job &>>) {
+            pool->offload(
+                    loop_, std::move(job), [self, seq, done = std::move(done)] { self->complete(seq, done); },
+                    std::move(on_error));
+        } else {
+            pool->offload(
+                    loop_, std::move(job),
+                    [self, seq, done = std::move(done)](auto result) {
+                        self->complete(seq, [done, result = std::move(result)]() mutable { done(std::move(result)); });
+                    },
+                    std::move(on_error));
+        }
+    }
+
+    /* 不需要计算的响应（如请求格式错误）也按顺序排在之前的结果之后 */
+    void post(EventLoop::Functor fn) {
+        complete(next_seq_++, std::move(fn));
+    }
+
+    size_t inflight() const {
+        return next_seq_ - next_done_;
+    }
+
+private:
+    void complete(uint64_t seq, EventLoop::Functor fn) {
+        ready_.emplace(seq, std::move(fn));
+        while (!ready_.empty() && ready_.begin()->first == next_done_) {//之前的都已完成才依次执行
+            EventLoop::Functor f = std::move(ready_.begin()->second);
+            ready_.erase(ready_.begin());
+            ++next_done_;
+            f();
+        }
+    }
+
+    EventLoop *loop_;
+    uint64_t next_seq_;
+    uint64_t next_done_;
+    std::map<uint64_t, EventLoop::Functor> ready_;
+};
+
+#endif//MYMUDUO_COMPUTETHREADPOOL_H
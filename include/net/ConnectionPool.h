@@ -0,0 +1,91 @@
+#ifndef MYMUDUO_CONNECTIONPOOL_H
+#define MYMUDUO_CONNECTIONPOOL_H
+
+#include "base/noncopyable.h"
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* 每个io loop一个连接内存池
+ * TcpConnection（内含Socket、Channel）与shared_ptr控制块通过allocate_shared一次分配，释放后放回空闲链表
+ * 连接析构时把输入输出Buffer的存储归还，新连接直接复用；归还的存储总量不超过max_spare_bytes
+ * 空闲链表只在属主线程（第一次allocate的线程，即io线程）中访问，其他线程释放的块先放入加锁的remote链表
+ * */
+
+class ConnectionPool : private noncopyable, public std::enable_shared_from_this<ConnectionPool> {
+public:
+    /* 供allocate_shared使用，持有pool的引用，保证池在最后一个连接释放前存活 */
+    template<typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+
+        explicit Allocator(std::shared_ptr<ConnectionPool> pool) : pool_(std::move(pool)) {}
+
+        template<typename U>
+        Allocator(const Allocator<U> &other) : pool_(other.pool_) {}
+
+        T *allocate(size_t n) {
+            return static_cast<T *>(pool_->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t n) {
+            pool_->deallocate(p, n * sizeof(T));
+        }
+
+        template<typename U>
+        bool operator==(const Allocator<U> &other) const {
+            return pool_ == other.pool_;
+        }
+
+        template<typename U>
+        bool operator!=(const Allocator<U> &other) const {
+            return pool_ != other.pool_;
+        }
+
+    private:
+        template<typename U>
+        friend class Allocator;
+        std::shared_ptr<ConnectionPool> pool_;
+    };
+
+    explicit ConnectionPool(size_t max_free = 1024, size_t max_spare_bytes = 4 * 1024 * 1024);
+
+    ~ConnectionPool();
+
+    void *allocate(size_t size);
+
+    void deallocate(void *p, size_t size);
+
+    /* 以下两个只在属主线程中调用 */
+    std::vector<char> takeBufferStorage();
+
+    void recycleBufferStorage(std::vector<char> storage);
+
+    bool isOwnerThread() const {
+        return owner_ == std::this_thread::get_id();
+    }
+
+private:
+    static const size_t MaxRecycledBufferSize = 64 * 1024;
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static void freeList(FreeBlock *list);
+
+    size_t max_free_;
+    size_t max_spare_bytes_;
+    size_t spare_bytes_;
+    size_t block_size_;
+    std::thread::id owner_;
+    FreeBlock *free_list_;
+    size_t free_count_;
+    std::mutex remote_mutex_;
+    FreeBlock *remote_list_;
+    std::vector<std::vector<char>> spare_buffers_;
+};
+
+#endif//MYMUDUO_CONNECTIONPOOL_H
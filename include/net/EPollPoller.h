@@ -18,6 +18,9 @@ public:
     /* poll中若有事件发生， 则把epoll_wait()返回的fd们对应的channel放入active_channels*/
     Timestamp poll(int timeout_ms, ChannelList *active_channels) override;
 
+    /* 使用epoll_pwait2，内核不支持(<5.11)时退回epoll_wait */
+    Timestamp pollNs(int64_t timeout_ns, ChannelList *active_channels) override;
+
     /* 更新，新增channel，并放入监听 */
     void updateChannel(Channel *channel) override;
 
@@ -28,6 +31,8 @@ private:
 
     void fillActivateChannels(int num_events, ChannelList *activate_channels) const;
 
+    Timestamp afterPoll(int num_events, int save_errno, ChannelList *active_channels);
+
     void update(int operation, Channel *channel);
 
     using EventList = std::vector<epoll_event>;
@@ -35,6 +40,7 @@ private:
 private:
     int epoll_fd_;
     EventList events_;
+    bool pwait2_supported_;
 };
 
 
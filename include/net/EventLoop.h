@@ -5,6 +5,7 @@
 #include "base/Timestamp.h"
 #include "base/noncopyable.h"
 #include "net/TimerId.h"
+#include "net/TimerQueue.h"
 #include <atomic>
 #include <functional>
 #include <memory>
@@ -13,8 +14,6 @@
 
 class Channel;
 
-class TimerQueue;
-
 class Poller;
 
 /* 事件循环
@@ -38,11 +37,32 @@ public:
         return poll_return_time_;
     }
 
-    TimerId runAt(const Timestamp& time, const TimerCallback& cb);
+    /* 每轮poll返回时更新一次的缓存时间，在loop线程中代替Timestamp::now()，精度为本轮事件处理的耗时 */
+    Timestamp now() const {
+        return poll_return_time_;
+    }
+
+    /* 累计处理事件与回调的时间（不含poll等待），可在其他线程读取 */
+    int64_t busyNanos() const;
+
+    /* slack为允许推迟执行的秒数，相近的定时器合并为一次唤醒；小于0时使用setTimerSlack设置的默认值 */
+    TimerId runAt(const Timestamp &time, const TimerCallback &cb, double slack = -1.0);
 
-    TimerId runAfter(double delay, const TimerCallback& cb);
+    TimerId runAfter(double delay, const TimerCallback &cb, double slack = -1.0);
 
-    TimerId runEvery(double interval, const TimerCallback &cb);
+    TimerId runEvery(double interval, const TimerCallback &cb, double slack = -1.0);
+
+    void setTimerSlack(double slack);
+
+    void cancel(TimerId timer_id);
+
+    /* 替换定时器队列的实现，只能在loop线程中、添加定时器之前调用（如ThreadInitCallback中） */
+    void setTimerQueueType(TimerQueue::Type type);
+
+    /* 不使用timerfd，poll的超时设为最近的定时器（epoll_pwait2，纳秒精度），定时器不再需要额外的系统调用
+     * 与setTimerQueueType一样只能在添加定时器之前调用
+     * */
+    void setPollTimers(bool on);
 
     void runInLoop(Functor cb);
 
@@ -65,6 +85,8 @@ private:
 
     void doPendingFunctors();
 
+    void resetTimerQueue(TimerQueue::Type type, bool poll_timers);
+
     std::atomic_bool looping_;
     std::atomic_bool quit_;
     const std::thread::id thread_id_;
@@ -72,8 +94,12 @@ private:
     Timestamp poll_return_time_;
     std::unique_ptr<Poller> poller_;
     std::unique_ptr<TimerQueue> timer_queue_;
+    TimerQueue::Type timer_queue_type_;
+    bool poll_timers_;
     std::unique_ptr<Channel> wakeup_channel_;
     ChannelList active_channels_;
+    std::atomic_int64_t busy_nanos_;
+    std::atomic_int64_t busy_since_;
     std::atomic_bool calling_pending_functions_;
     std::vector<Functor> pending_functors_;
     std::mutex mutex_;
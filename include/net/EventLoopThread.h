@@ -1,6 +1,7 @@
 #ifndef MYMUDUO_EVENTLOOPTHREAD_H
 #define MYMUDUO_EVENTLOOPTHREAD_H
 
+#include "base/CpuAffinity.h"
 #include "base/noncopyable.h"
 #include <thread>
 #include <string>
@@ -12,7 +13,8 @@ class EventLoop;
 class EventLoopThread : private noncopyable {
 public:
     using ThreadInitCallback = std::function<void(EventLoop *)>;
-    explicit EventLoopThread(ThreadInitCallback cb = ThreadInitCallback(), std::string name = std::string());
+    explicit EventLoopThread(ThreadInitCallback cb = ThreadInitCallback(), std::string name = std::string(),
+                             CpuAffinity::CpuSet cpus = CpuAffinity::CpuSet());
 
     ~EventLoopThread();
 
@@ -27,6 +29,7 @@ private:
     std::mutex mutex_;
     std::condition_variable cond_;
     ThreadInitCallback callback_;
+    CpuAffinity::CpuSet cpus_;
 };
 
 
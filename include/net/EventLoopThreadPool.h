@@ -1,19 +1,39 @@
 #ifndef MYMUDUO_EVENTLOOPTHREADPOOL_H
 #define MYMUDUO_EVENTLOOPTHREADPOOL_H
 
+#include "base/CpuAffinity.h"
 #include "base/noncopyable.h"
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 class EventLoop;
 
 class EventLoopThread;
 
+class InetAddress;
+
+/* 新连接分配策略
+ * RoundRobin 轮流分配
+ * LeastConnections 当前连接数最少的loop
+ * LeastLoad 最近一段时间忙碌时间最少的loop
+ * HashPeer 按对端ip哈希，同一客户端落在同一loop
+ * */
+
 class EventLoopThreadPool : private noncopyable {
 public:
     using ThreadInitCallback = std::function<void(EventLoop *)>;
+    using DispatchCallback = std::function<size_t(const std::vector<EventLoop *> &, const InetAddress &)>;
+    enum DispatchPolicy {
+        RoundRobin,
+        LeastConnections,
+        LeastLoad,
+        HashPeer,
+    };
 
     EventLoopThreadPool(EventLoop *base_loop, std::string name);
 
@@ -23,10 +43,35 @@ public:
         num_threads_ = num;
     }
 
+    /* 第i个io线程绑定到cpu_sets[i % size]，需在start前调用 */
+    void setThreadAffinity(std::vector<CpuAffinity::CpuSet> cpu_sets) {
+        cpu_sets_ = std::move(cpu_sets);
+    }
+
+    void setDispatchPolicy(DispatchPolicy policy) {
+        policy_ = policy;
+    }
+
+    /* 自定义策略，返回loops中的下标，优先于DispatchPolicy */
+    void setDispatchCallback(DispatchCallback cb) {
+        dispatch_callback_ = std::move(cb);
+    }
+
     void start(const ThreadInitCallback &cb = ThreadInitCallback());
 
     EventLoop *getNextLoop();
 
+    /* 按策略为新连接选择loop，并计入该loop的连接数 */
+    EventLoop *getLoopForConnection(const InetAddress &peer_addr);
+
+    /* 不经过策略，直接计入loop的连接数（如连接由该loop自己accept） */
+    void acquireConnection(EventLoop *loop);
+
+    /* 连接销毁时调用，可在任意线程 */
+    void releaseConnection(EventLoop *loop);
+
+    int connectionCount(EventLoop *loop) const;
+
     std::vector<EventLoop *> getAllLoops();
 
     bool started() const {
@@ -38,13 +83,31 @@ public:
     }
 
 private:
+    /* 每个loop的连接计数，start后只读地查找，计数本身用原子变量 */
+    struct LoopStats {
+        std::atomic_int connections{0};
+        int64_t busy_snapshot = 0;
+        int64_t recent_busy = 0;
+    };
+
+    size_t pickIndex(const InetAddress &peer_addr);
+
+    void refreshLoad();
+
     EventLoop *base_loop_;
     std::string name_;
     bool started_;
     int num_threads_;
-    int next_;
+    size_t next_;//无符号，回绕有定义；getNextLoop和pickIndex共用，用时取模
+    DispatchPolicy policy_;
+    DispatchCallback dispatch_callback_;
     std::vector<std::unique_ptr<EventLoopThread>> threads_;
     std::vector<EventLoop *> loops_;
+    std::vector<CpuAffinity::CpuSet> cpu_sets_;
+    std::vector<EventLoop *> dispatch_loops_;
+    std::vector<std::unique_ptr<LoopStats>> stats_;
+    std::unordered_map<EventLoop *, LoopStats *> stats_index_;
+    int64_t load_window_start_;
 };
 
 #endif//MYMUDUO_EVENTLOOPTHREADPOOL_H
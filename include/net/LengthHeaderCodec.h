@@ -0,0 +1,53 @@
+#ifndef MYMUDUO_LENGTHHEADERCODEC_H
+#define MYMUDUO_LENGTHHEADERCODEC_H
+
+#include "Buffer.h"
+#include "Callbacks.h"
+#include "base/Timestamp.h"
+#include "base/noncopyable.h"
+#include <functional>
+#include <string_view>
+
+/* 长度前缀分帧：每帧为4字节网络序长度加消息体
+ * 编码时把长度写入Buffer的预留区（cheap_prepend），消息体不移动
+ * 解码时对一次读到的所有完整帧依次回调，frame直接指向输入Buffer，只在回调期间有效
+ * 长度超过max_frame_size时无法再同步到帧边界，调用错误回调；默认记录日志后关闭连接
+ *   LengthHeaderCodec codec([](const TcpConnectionPtr &conn, std::string_view frame, Timestamp) { ... });
+ *   server.setMessageCallback([&codec](auto &&conn, auto *buf, auto time) { codec.onMessage(conn, buf, time); });
+ * */
+
+class LengthHeaderCodec : private noncopyable {
+public:
+    using FrameCallback = std::function<void(const TcpConnectionPtr &, std::string_view, Timestamp)>;
+    using ErrorCallback = std::function<void(const TcpConnectionPtr &, size_t)>;
+
+    static constexpr size_t HeaderLen = sizeof(int32_t);
+    static constexpr size_t DefaultMaxFrameSize = 64 * 1024 * 1024;
+
+    explicit LengthHeaderCodec(FrameCallback cb, size_t max_frame_size = DefaultMaxFrameSize);
+
+    void setErrorCallback(ErrorCallback cb) {
+        error_callback_ = std::move(cb);
+    }
+
+    size_t maxFrameSize() const {
+        return max_frame_size_;
+    }
+
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time);
+
+    /* 把buf中的全部可读数据作为一帧，长度写入预留区 */
+    static void encode(Buffer *buf);
+
+    /* 编码后发送，buf被清空 */
+    static void send(const TcpConnectionPtr &conn, Buffer *buf);
+
+    static void send(const TcpConnectionPtr &conn, std::string_view frame);
+
+private:
+    FrameCallback frame_callback_;
+    ErrorCallback error_callback_;
+    size_t max_frame_size_;
+};
+
+#endif//MYMUDUO_LENGTHHEADERCODEC_H
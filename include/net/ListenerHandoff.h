@@ -0,0 +1,53 @@
+#ifndef MYMUDUO_LISTENERHANDOFF_H
+#define MYMUDUO_LISTENERHANDOFF_H
+
+#include "Channel.h"
+#include "base/noncopyable.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+class EventLoop;
+
+/* 重启时把listen socket交给新进程，避免丢失accept队列
+ * 旧进程在path上监听unix socket，新进程用takeOver连接后通过SCM_RIGHTS收到listen fd，
+ * 新进程用这些fd构造TcpServer并立即开始accept，旧进程在HandoffCallback中drain
+ * 只交接一次，交接后关闭unix socket
+ * */
+
+class ListenerHandoff : private noncopyable {
+public:
+    using ListenFdsProvider = std::function<std::vector<int>()>;
+    using HandoffCallback = std::function<void()>;
+
+    ListenerHandoff(EventLoop *loop, std::string path);
+
+    ~ListenerHandoff();
+
+    void setListenFdsProvider(const ListenFdsProvider &provider) {
+        provider_ = provider;
+    }
+
+    void setHandoffCallback(const HandoffCallback &cb) {
+        handoff_callback_ = cb;
+    }
+
+    void start();
+
+    /* 新进程调用，阻塞最多timeout秒；没有旧进程在path上监听时返回空 */
+    static std::vector<int> takeOver(const std::string &path, double timeout = 5.0);
+
+private:
+    void handleRead();
+
+    void closeListener();
+
+    EventLoop *loop_;
+    std::string path_;
+    int listen_fd_;
+    Channel channel_;
+    ListenFdsProvider provider_;
+    HandoffCallback handoff_callback_;
+};
+
+#endif//MYMUDUO_LISTENERHANDOFF_H
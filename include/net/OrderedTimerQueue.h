@@ -0,0 +1,57 @@
+#ifndef MYMUDUO_ORDEREDTIMERQUEUE_H
+#define MYMUDUO_ORDEREDTIMERQUEUE_H
+
+#include "TimerQueue.h"
+#include <vector>
+
+/* 用数组上的4叉最小堆存放定时器，按deadline排序，堆元素中存放时间，比较时不需要访问Timer
+ * 取到期定时器时从堆顶开始，只要堆顶的到期时间已过就取出，因此窗口已开始的定时器会在同一次唤醒中执行
+ * Timer记录自己在堆中的下标，cancel时直接从该位置删除
+ * deadline相同时按创建顺序执行
+ * */
+
+class OrderedTimerQueue : public TimerQueue {
+public:
+    OrderedTimerQueue(EventLoop *loop, bool use_timerfd);
+
+    ~OrderedTimerQueue() override = default;
+
+    size_t size() const override {
+        return heap_.size();
+    }
+
+protected:
+    void insert(Timer *timer) override;
+
+    bool erase(Timer *timer) override;
+
+    void takeExpired(Timestamp now, std::vector<Timer *> *expired) override;
+
+    Timestamp earliest() const override;
+
+private:
+    static const size_t Arity = 4;
+
+    struct Entry {
+        Timestamp deadline;
+        Timestamp when;
+        int64_t sequence;
+        Timer *timer;
+    };
+
+    static bool before(const Entry &lhs, const Entry &rhs) {
+        return lhs.deadline < rhs.deadline || (lhs.deadline == rhs.deadline && lhs.sequence < rhs.sequence);
+    }
+
+    void removeAt(size_t index);
+
+    void siftUp(size_t index);
+
+    void siftDown(size_t index);
+
+    void moveTo(Entry entry, size_t index);
+
+    std::vector<Entry> heap_;
+};
+
+#endif//MYMUDUO_ORDEREDTIMERQUEUE_H
@@ -20,6 +20,9 @@ public:
 
     virtual Timestamp poll(int timeoutMs, ChannelList *active_channels) = 0;
 
+    /* 纳秒精度的超时，小于0表示一直等待；默认向上取整到毫秒后调用poll */
+    virtual Timestamp pollNs(int64_t timeout_ns, ChannelList *active_channels);
+
     virtual void updateChannel(Channel *channel) = 0;
 
     virtual void removeChannel(Channel *channel) = 0;
@@ -63,6 +63,13 @@ public:
         }
     }
 
+    /* 配合SO_REUSEPORT，内核优先把在该cpu上处理的连接交给此socket */
+    void setIncomingCpu(int cpu) {
+        if (setsockopt(fd_, SOL_SOCKET, SO_INCOMING_CPU, &cpu, static_cast<socklen_t>(sizeof(cpu))) < 0) {
+            LOG_ERROR << "setIncomingCpu error!";
+        }
+    }
+
     void setKeepAlive(bool on) {
         int optval = on ? 1 : 0;
         setsockopt(fd_, SOL_SOCKET, SO_KEEPALIVE, &optval, static_cast<socklen_t>(sizeof(optval)));
@@ -3,11 +3,15 @@
 
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <string>
 #include <sys/uio.h>
+#include <vector>
 
 namespace SocketOps {
     int createNonblockingSocket(sa_family_t family);
 
+    int createNonblockingUdpSocket(sa_family_t family);
+
     int connect(int fd, const sockaddr *addr);
 
     void bind(int fd, const sockaddr *addr);
@@ -32,6 +36,12 @@ namespace SocketOps {
 
     struct sockaddr_in getPeerAddr(int sockfd);
 
+    /* 通过unix domain socket以SCM_RIGHTS传递fd，payload随fd一起发送，失败返回false */
+    bool sendFds(int unix_fd, const std::vector<int> &fds, const std::string &payload);
+
+    /* 接收sendFds发送的fd（带CLOEXEC），失败返回false */
+    bool recvFds(int unix_fd, std::vector<int> *fds, std::string *payload);
+
 }// namespace SocketOps
 
 #endif//MYMUDUO_SOCKETOPS_H
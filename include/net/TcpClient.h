@@ -42,6 +42,16 @@ public:
         write_complete_callback_ = std::move(cb);
     }
 
+#ifdef MYMUDUO_HAS_TLS
+    /* connect之前调用，之后的连接都走TLS；server_name用于SNI和证书校验，同时作为会话复用的key
+     * server_name为空时按服务端地址复用会话，校验证书时要求证书包含服务端IP；context的生命周期要长于TcpClient
+     * */
+    void setTlsContext(TlsContext *context, std::string server_name = std::string()) {
+        tls_context_ = context;
+        tls_server_name_ = std::move(server_name);
+    }
+#endif
+
 private:
     void newConnection(int sockfd);
     void removeConnection(const TcpConnectionPtr &conn);
@@ -56,6 +66,10 @@ private:
     int next_connid_;
     mutable std::mutex mutex_;
     TcpConnectionPtr connection_;
+#ifdef MYMUDUO_HAS_TLS
+    TlsContext *tls_context_ = nullptr;
+    std::string tls_server_name_;
+#endif
 };
 
 #endif//MYMUDUO_TCPCLIENT_H
@@ -3,23 +3,36 @@
 
 #include "Buffer.h"
 #include "Callbacks.h"
+#include "Channel.h"
 #include "InetAddress.h"
+#include "Socket.h"
 #include "base/noncopyable.h"
 #include <any>
 #include <atomic>
+#include <memory>
 #include <utility>
 
 class EventLoop;
 
-class Socket;
+class ConnectionPool;
 
-class Channel;
+class TlsContext;
+
+class TlsFilter;
 
 class TcpConnection : private noncopyable, public std::enable_shared_from_this<TcpConnection> {
 public:
     TcpConnection(EventLoop *t, std::string name, int sockfd,
                   const InetAddress &local_addr,
                   const InetAddress &peer_addr);
+
+    /* 名字在第一次调用name()时才由 name_prefix#id 拼出
+     * pool非空时Buffer使用池中回收的存储，析构时归还
+     * */
+    TcpConnection(EventLoop *t, uint64_t id, std::shared_ptr<const std::string> name_prefix, int sockfd,
+                  const InetAddress &local_addr,
+                  const InetAddress &peer_addr,
+                  ConnectionPool *pool = nullptr);
     ~TcpConnection();
 
     void setConnectionCallback(const ConnectionCallback &cb) {
@@ -43,7 +56,15 @@ public:
         close_callback_ = cb;
     }
 
+    uint64_t id() const {
+        return id_;
+    }
+
+    /* 惰性生成，需在loop线程中调用 */
     const std::string &name() const {
+        if (name_.empty() && name_prefix_) {
+            name_ = *name_prefix_ + "#" + std::to_string(id_);
+        }
         return name_;
     }
 
@@ -53,6 +74,11 @@ public:
 
     void send(const std::string &buf);
 
+    void send(const void *data, size_t len);
+
+    /* 在loop线程中直接发送buf中的数据，其他线程中复制一份；无论是否发送，buf都被清空 */
+    void send(Buffer *buf);
+
     void shutdown();
 
     void forceClose();
@@ -63,6 +89,11 @@ public:
         return state_ == Connected;
     }
 
+    /* 输入输出缓冲都为空，在连接所在的loop线程中调用 */
+    bool idle() const {
+        return input_buffer_.readableBytes() == 0 && output_buffer_.readableBytes() == 0;
+    }
+
     const InetAddress &localAddress() const {
         return local_addr_;
     }
@@ -71,6 +102,19 @@ public:
         return peer_addr_;
     }
 
+#ifdef MYMUDUO_HAS_TLS
+    /* 在connectEstablished之前调用，之后MessageCallback收到的是明文，send发送的是明文
+     * 握手完成前send的数据暂存在输出Buffer中，握手完成后发出；握手失败时关闭连接
+     * 客户端的session_key非空时按它复用会话
+     * */
+    void startTls(TlsContext *context, const std::string &server_name = std::string(),
+                  std::string session_key = std::string());
+
+    const TlsFilter *tls() const {
+        return tls_.get();
+    }
+#endif
+
     void connectEstablished();
 
     void connectDestroyed();
@@ -107,16 +151,26 @@ private:
 
     void handleError();
 
-    void sendInLoop(const std::string &msg);
+    void sendInLoop(const char *data, size_t len);
 
     void shutdownInLoop();
 
+#ifdef MYMUDUO_HAS_TLS
+    void handleTlsRead(Timestamp receive_time);
+
+    //推进握手并按需要开关写事件，完成时返回true
+    bool tlsHandshake();
+#endif
+
     EventLoop *loop_;
-    const std::string name_;
+    const uint64_t id_;
+    std::shared_ptr<const std::string> name_prefix_;
+    mutable std::string name_;
     std::atomic_int state_;
     bool reading_;
-    std::unique_ptr<Socket> socket_;
-    std::unique_ptr<Channel> channel_;
+    ConnectionPool *pool_;
+    Socket socket_;
+    Channel channel_;
 
     const InetAddress local_addr_;
     const InetAddress peer_addr_;
@@ -130,6 +184,9 @@ private:
     Buffer input_buffer_;
     Buffer output_buffer_;
     std::any context_;
+#ifdef MYMUDUO_HAS_TLS
+    std::unique_ptr<TlsFilter> tls_;
+#endif
 };
 
 void defaultConnectionCallback(const TcpConnectionPtr &conn);
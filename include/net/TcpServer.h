@@ -1,5 +1,6 @@
 #include "Acceptor.h"
 #include "Callbacks.h"
+#include "ConnectionPool.h"
 #include "EventLoop.h"
 #include "EventLoopThreadPool.h"
 #include "InetAddress.h"
@@ -18,13 +19,28 @@
 class TcpServer : private noncopyable {
 public:
     using ThreadInitCallback = std::function<void(EventLoop *)>;
+    using DrainCallback = std::function<void(size_t remaining, bool done)>;
+    using IdlePredicate = std::function<bool(const TcpConnectionPtr &)>;
+    /* PerLoopReusePort 每个io loop各自bind一个SO_REUSEPORT的listen socket并accept
+     * PerLoopExclusive 共用一个listen socket，每个io loop以EPOLLEXCLUSIVE监听
+     * 两种方式下连接都在accept它的loop中建立，不经过base loop
+     * */
     enum Option {
         NoReusePort,
         ReusePort,
+        PerLoopReusePort,
+        PerLoopExclusive,
     };
 
     TcpServer(EventLoop *loop, const InetAddress &addr, std::string name, Option option = NoReusePort);
 
+    /* 使用从旧进程继承的listen fd（见ListenerHandoff），不再创建和bind
+     * PerLoopReusePort时每个fd一个Acceptor，fd多于loop数时轮流分给各loop，少于时其余loop新建socket加入同一组
+     * 其他模式只使用第一个fd
+     * */
+    TcpServer(EventLoop *loop, const InetAddress &addr, std::string name, std::vector<int> inherited_fds,
+              Option option = NoReusePort);
+
     ~TcpServer();
 
     void setThreadInitCallback(const ThreadInitCallback &cb) {
@@ -45,28 +61,106 @@ public:
 
     void setThreadNum(int num);
 
+    void setThreadAffinity(std::vector<CpuAffinity::CpuSet> cpu_sets);
+
+    void setDispatchPolicy(EventLoopThreadPool::DispatchPolicy policy);
+
+    /* PerLoopReusePort时为每个listen socket设置SO_INCOMING_CPU为其loop所在cpu，需配合绑核使用 */
+    void setIncomingCpu(bool on) {
+        incoming_cpu_ = on;
+    }
+
+    /* 每次listen socket可读时最多accept的连接数 */
+    void setAcceptBudget(int budget) {
+        accept_budget_ = budget;
+    }
+
+#ifdef MYMUDUO_HAS_TLS
+    /* start之前调用，之后接受的连接都先做TLS握手；context的生命周期要长于TcpServer */
+    void setTlsContext(TlsContext *context) {
+        tls_context_ = context;
+    }
+#endif
+
     void start();
 
+    /* drain时判断连接上是否还有未完成的请求（如交给计算线程池、尚未回复的请求），返回true表示空闲
+     * 在连接所在的io线程中调用，start之前设置；未设置时只看输入输出缓冲是否为空
+     * */
+    void setIdlePredicate(IdlePredicate predicate) {
+        idle_predicate_ = std::move(predicate);
+    }
+
+    /* 平滑关闭：关闭Acceptor不再接受新连接，只对空闲的连接shutdown，等待对端关闭
+     * 忙碌的连接每report_interval秒重新检查一次，空闲后再shutdown；timeout秒后强制关闭剩余连接
+     * progress每report_interval秒在base loop中调用一次，done为true时为最后一次；report_interval必须大于0
+     * */
+    void drain(double timeout, DrainCallback progress, double report_interval = 0.5);
+
+    size_t numConnections() const;
+
+    /* start之后调用，返回可交给新进程的listen fd */
+    std::vector<int> listenFds() const;
+
 private:
-    void newConnection(int sockfd, const InetAddress &peer_addr);
+    /* 每个io loop一个连接分片，只在该loop线程中访问，连接的建立与销毁都不离开该线程
+     * 连接id高16位为分片序号，低48位为分片内递增序号
+     * 连接从分片的ConnectionPool中一次分配
+     * */
+    struct Shard {
+        EventLoop *loop = nullptr;
+        uint64_t index = 0;
+        uint64_t next_seq = 0;
+        bool draining = false;
+        std::atomic_size_t live{0};//供其他线程读取连接数
+        std::unordered_map<uint64_t, TcpConnectionPtr> connections;
+        std::shared_ptr<ConnectionPool> pool;
+        EventLoopThreadPool *thread_pool = nullptr;//不持有，TcpServer析构时在分片loop中置空
+        IdlePredicate idle_predicate;
+    };
+    using ShardPtr = std::shared_ptr<Shard>;
+
+    void newConnections(std::vector<Acceptor::AcceptedConnection> &batch);
+
+    void establishConnection(EventLoop *io_loop, int sockfd, const InetAddress &peer_addr);
+
+    static void removeConnection(Shard *shard, const TcpConnectionPtr &conn);
+
+    //drain期间对空闲的连接shutdown
+    static void shutdownIfIdle(Shard *shard, const TcpConnectionPtr &conn);
 
-    void removeConnection(const TcpConnectionPtr &conn);
+    void stopAccepting();
 
-    void removeConnectionInLoop(const TcpConnectionPtr &conn);
+    void checkDrain();
 
-    using ConnectionMap = std::unordered_map<std::string, TcpConnectionPtr>;
     EventLoop *loop_;
+    const InetAddress listen_addr_;
     const std::string ip_port_;
     const std::string name_;
+    const Option option_;
+    bool incoming_cpu_;
+    int accept_budget_;
     std::unique_ptr<Acceptor> acceptor_;
+    std::unique_ptr<Socket> shared_socket_;
     std::shared_ptr<EventLoopThreadPool> thread_pool_;
+    std::vector<std::unique_ptr<Acceptor>> loop_acceptors_;
+    std::vector<int> inherited_fds_;
     ConnectionCallback connection_callback_;
     MessageCallback message_callback_;
     WriteCompleteCallback write_complete_callback_;
     ThreadInitCallback thread_init_callback_;
+    IdlePredicate idle_predicate_;
     std::atomic_int started_;
-    int next_conn_id_;
-    ConnectionMap connections_;
+    std::shared_ptr<const std::string> conn_name_prefix_;
+    std::unordered_map<EventLoop *, ShardPtr> shards_;
+    bool draining_;
+#ifdef MYMUDUO_HAS_TLS
+    TlsContext *tls_context_ = nullptr;
+#endif
+    bool drain_forced_;
+    Timestamp drain_deadline_;
+    TimerId drain_timer_;
+    DrainCallback drain_callback_;
 };
 
 
@@ -8,12 +8,14 @@
 
 class Timer : noncopyable {
 public:
-    Timer(TimerCallback cb, Timestamp when, double interval)
+    Timer(TimerCallback cb, Timestamp when, double interval, double slack = 0.0)
         : callback_(std::move(cb)),
           expiration_(when),
           interval_(interval),
+          slack_(slack > 0.0 ? slack : 0.0),
           repeat_(interval > 0.0),
-          sequence_(++s_num_created_) {}
+          sequence_(++s_num_created_),
+          prev_(nullptr), next_(nullptr), index_(-1), canceled_(false) {}
 
     void run() const {
         callback_();
@@ -23,6 +25,11 @@ public:
         return expiration_;
     }
 
+    /* 最晚执行时间，可在[expiration, deadline]内任意时刻执行 */
+    Timestamp deadline() const {
+        return slack_ > 0.0 ? expiration_ + slack_ : expiration_;
+    }
+
     bool repeat() const {
         return repeat_;
     }
@@ -31,6 +38,15 @@ public:
         return sequence_;
     }
 
+    /* 正在执行或尚未加入队列时被cancel，之后不再加入 */
+    void cancel() {
+        canceled_ = true;
+    }
+
+    bool canceled() const {
+        return canceled_;
+    }
+
     void restart(Timestamp now) {
         if (repeat_) {
             expiration_ = now + interval_;
@@ -44,11 +60,19 @@ public:
     }
 
 private:
+    friend class OrderedTimerQueue;
+    friend class TimerWheel;
+
     const TimerCallback callback_;
     Timestamp expiration_;  //到期
     const double interval_; //间隔
+    const double slack_;    //允许推迟的时间
     const bool repeat_;     //重复
     const int64_t sequence_;//序列
+    Timer *prev_;           //TimerWheel槽中的双向链表
+    Timer *next_;
+    int index_;             //在堆中的下标或时间轮中的槽，-1表示不在队列中
+    bool canceled_;
     inline static std::atomic_int64_t s_num_created_;
 };
 
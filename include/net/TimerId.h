@@ -2,20 +2,24 @@
 #define MYMUDUO_TIMERID_H
 
 #include "base/copyable.h"
+#include <cstdint>
 
-class Timer;
+/* 定时器句柄：TimerPool中的槽号与该槽的代数
+ * 定时器释放后槽的代数改变，旧的TimerId自动失效，可以安全地重复cancel
+ * */
 
 class TimerId : public copyable {
 public:
-    TimerId() : timer_(nullptr),
-                sequence_(0) {}
-    TimerId(Timer *timer, int64_t seq)
-        : timer_(timer), sequence_(seq) {}
-    friend class TimerQueue;
+    TimerId() : index_(0), generation_(0) {}
+
+    TimerId(uint32_t index, uint32_t generation)
+        : index_(index), generation_(generation) {}
+
+    friend class TimerPool;
 
 private:
-    Timer *timer_;
-    int64_t sequence_;
+    uint32_t index_;
+    uint32_t generation_;
 };
 
 #endif//MYMUDUO_TIMERID_H
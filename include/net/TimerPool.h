@@ -0,0 +1,48 @@
+#ifndef MYMUDUO_TIMERPOOL_H
+#define MYMUDUO_TIMERPOOL_H
+
+#include "Callbacks.h"
+#include "TimerId.h"
+#include "base/Timestamp.h"
+#include "base/noncopyable.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Timer;
+
+/* 每个TimerQueue一个Timer内存池，按1024个一块分配，块的地址不变
+ * 每个槽有一个代数，奇数表示使用中，分配和释放时各加一，TimerId记录分配时的代数
+ * allocate可在任意线程调用（加锁），release和get只在loop线程中调用
+ * */
+
+class TimerPool : private noncopyable {
+public:
+    TimerPool();
+
+    ~TimerPool();
+
+    Timer *allocate(TimerCallback cb, Timestamp when, double interval, double slack, TimerId *timer_id);
+
+    void release(Timer *timer);
+
+    /* timer_id对应的定时器仍存在时返回它，否则返回nullptr */
+    Timer *get(TimerId timer_id) const;
+
+private:
+    static const int ChunkBits = 10;
+    static const uint32_t ChunkSize = 1u << ChunkBits;
+    static const uint32_t MaxChunks = 4096;
+
+    struct Slot;
+
+    Slot *slotAt(uint32_t index) const;
+
+    std::mutex mutex_;
+    std::vector<uint32_t> free_slots_;
+    std::unique_ptr<Slot[]> chunks_[MaxChunks];
+    std::atomic_uint32_t num_slots_;
+};
+
+#endif//MYMUDUO_TIMERPOOL_H
@@ -2,10 +2,10 @@
 #define MYMUDUO_TIMERQUEUE_H
 #include "Callbacks.h"
 #include "Channel.h"
+#include "TimerPool.h"
 #include "base/Timestamp.h"
 #include "base/noncopyable.h"
-#include <set>
-#include <utility>
+#include <atomic>
 #include <vector>
 
 class EventLoop;
@@ -14,32 +14,77 @@ class Timer;
 
 class TimerId;
 
+/* 定时器队列，用timerfd在最早的deadline唤醒loop
+ * 定时器可带slack，在[到期时间, 到期时间+slack]内执行，唤醒时把窗口已开始的定时器一起执行，减少唤醒和timerfd_settime
+ * Timer从本队列的TimerPool中分配，TimerId为带代数的句柄，cancel时直接按槽号找到Timer
+ * 定时器的存放由子类实现：OrderedTimerQueue为4叉最小堆，TimerWheel为分层时间轮，Timer记录自己在其中的位置
+ * 子类接口只在loop线程中调用
+ * */
+
 class TimerQueue : noncopyable {
 public:
-    explicit TimerQueue(EventLoop *loop);
-    ~TimerQueue();
-    TimerId addTimer(TimerCallback cb, Timestamp when, double interval);
+    enum Type {
+        Ordered,
+        Wheel,
+    };
+
+    /* use_timerfd为false时不创建timerfd，由EventLoop用nextWakeup作为poll超时并调用processExpired */
+    static TimerQueue *newTimerQueue(EventLoop *loop, Type type, bool use_timerfd = true);
+
+    TimerQueue(EventLoop *loop, bool use_timerfd);
+
+    virtual ~TimerQueue();
+
+    /* slack小于0时使用默认slack */
+    TimerId addTimer(TimerCallback cb, Timestamp when, double interval, double slack = -1.0);
+
+    /* 默认slack，单位秒，初始为0 */
+    void setDefaultSlack(double slack) {
+        default_slack_ = slack;
+    }
+
+    double defaultSlack() const {
+        return default_slack_;
+    }
+
     void cancel(TimerId timerId);
 
+    /* 尚未到期的定时器数量 */
+    virtual size_t size() const = 0;
+
+    Timestamp nextWakeup() const {
+        return earliest();
+    }
+
+    /* 执行到期的定时器，now通常为本轮poll返回的时间 */
+    void processExpired(Timestamp now);
+
+protected:
+    virtual void insert(Timer *timer) = 0;
+
+    /* timer在队列中则移除并返回true */
+    virtual bool erase(Timer *timer) = 0;
+
+    /* 移除到期时间<=now的定时器放入expired，deadline<=now的必须全部移除 */
+    virtual void takeExpired(Timestamp now, std::vector<Timer *> *expired) = 0;
+
+    /* 下一次必须唤醒的时间（最早的deadline），没有定时器时返回Timestamp() */
+    virtual Timestamp earliest() const = 0;
+
+    EventLoop *loop_;
+
 private:
-    using Entry = std::pair<Timestamp, Timer *>;
-    using TimerList = std::set<Entry>;
-    using ActiveTimer = std::pair<Timer *, int64_t>;
-    using ActiveTimerSet = std::set<ActiveTimer>;
     void addTimerInLoop(Timer *timer);
     void cancelInLoop(TimerId timer_id);
-    void handleRead();
-    std::vector<Entry> getExpired(Timestamp now);
-    void reset(const std::vector<Entry> &expired, Timestamp now);
-    bool insert(Timer *timer);
+    void handleRead(Timestamp now);
+    void rearm();
 
-    EventLoop *loop_;
+    TimerPool pool_;
     const int timerfd_;
     Channel channel_;
-    TimerList timers_;
-    ActiveTimerSet active_timers_;
-    bool calling_expired_timers_;
-    ActiveTimerSet canceling_timers_;
+    Timestamp armed_;
+    std::vector<Timer *> expired_;
+    std::atomic<double> default_slack_;
 };
 
 #endif//MYMUDUO_TIMERQUEUE_H
@@ -0,0 +1,56 @@
+#ifndef MYMUDUO_TIMERWHEEL_H
+#define MYMUDUO_TIMERWHEEL_H
+
+#include "TimerQueue.h"
+#include <cstdint>
+
+/* 分层时间轮，tick为1ms，共4层每层64个槽，覆盖约4.6小时，更远的定时器放在最高层最后一个槽中，到时再重新放置
+ * 第0层的槽对应到期tick，第l层的槽对应到期tick>>6l，每个槽为Timer的侵入式双向链表，插入和取消都是O(1)
+ * 每层用一个64位bitmap记录非空槽，推进时直接跳到下一个非空槽，轮到高层的槽时把其中的定时器重新放置到低层
+ * 到期时间向上取整到tick，同一tick内到期的定时器执行顺序不保证
+ * */
+
+class TimerWheel : public TimerQueue {
+public:
+    TimerWheel(EventLoop *loop, bool use_timerfd);
+
+    ~TimerWheel() override = default;
+
+    size_t size() const override {
+        return size_;
+    }
+
+protected:
+    void insert(Timer *timer) override;
+
+    bool erase(Timer *timer) override;
+
+    void takeExpired(Timestamp now, std::vector<Timer *> *expired) override;
+
+    Timestamp earliest() const override;
+
+private:
+    static const int Levels = 4;
+    static const int SlotBits = 6;
+    static const int Slots = 1 << SlotBits;
+    static const int64_t NanoSecondsPerTick = 1000 * 1000;
+
+    static int64_t tickOf(Timestamp when);//向上取整
+
+    /* 有slack时对齐到窗口内末尾0最多的tick，使相近的定时器落在同一个tick，并尽量直接放在高层不必重新放置 */
+    static int64_t expireTickOf(const Timer *timer);
+
+    void place(Timer *timer, int64_t expire_tick);
+
+    void unlink(Timer *timer);
+
+    /* 下一个需要处理的tick（第0层为到期，其他层为重新放置），没有返回-1 */
+    int64_t nextEventTick() const;
+
+    int64_t current_tick_;
+    Timer *slots_[Levels][Slots];
+    uint64_t occupied_[Levels];
+    size_t size_;
+};
+
+#endif//MYMUDUO_TIMERWHEEL_H
@@ -0,0 +1,84 @@
+#ifndef MYMUDUO_TLSCONTEXT_H
+#define MYMUDUO_TLSCONTEXT_H
+
+#include "base/noncopyable.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct ssl_ctx_st;
+struct ssl_session_st;
+
+/* OpenSSL的SSL_CTX，同一服务器或同一组客户端的所有连接共享，线程安全
+ * 服务端：开启session ticket（密钥在SSL_CTX内，所有io线程共用）和会话缓存，重连的客户端可以跳过完整握手
+ * 客户端：按服务器名缓存最近一次的会话，下次连接同一服务器时携带
+ * kernel_tls为true时设置SSL_OP_ENABLE_KTLS，握手后由OpenSSL设置TCP_ULP "tls"，内核不支持时仍用用户态加解密
+ * 只在CMake找到OpenSSL时编译（MYMUDUO_HAS_TLS）
+ * */
+
+class TlsContext : private noncopyable {
+public:
+    enum Mode {
+        Server,
+        Client,
+    };
+
+    explicit TlsContext(Mode mode, bool kernel_tls = true);
+
+    ~TlsContext();
+
+    Mode mode() const {
+        return mode_;
+    }
+
+    /* PEM格式，服务端必须设置；失败时记录日志并返回false */
+    bool loadCertificate(const std::string &cert_file, const std::string &key_file);
+
+    /* 设置后校验对端证书，客户端还会校验证书与服务器名（没有服务器名时为对端IP）是否匹配 */
+    bool loadVerifyLocations(const std::string &ca_file);
+
+    ssl_ctx_st *native() const {
+        return ctx_;
+    }
+
+    bool verifyPeer() const {
+        return verify_peer_;
+    }
+
+    uint64_t handshakes() const {
+        return handshakes_.load(std::memory_order_relaxed);
+    }
+
+    /* 复用了会话的握手数 */
+    uint64_t resumedHandshakes() const {
+        return resumed_.load(std::memory_order_relaxed);
+    }
+
+    /* 发送方向开启了kTLS的连接数 */
+    uint64_t kernelTlsConnections() const {
+        return kernel_tls_.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class TlsFilter;
+
+    //客户端会话缓存，返回的会话已增加引用计数
+    ssl_session_st *getSession(const std::string &key);
+
+    void putSession(const std::string &key, ssl_session_st *session);
+
+    void onHandshakeDone(bool resumed, bool kernel_send);
+
+    const Mode mode_;
+    ssl_ctx_st *ctx_;
+    bool verify_peer_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, ssl_session_st *> sessions_;
+    std::atomic_uint64_t handshakes_;
+    std::atomic_uint64_t resumed_;
+    std::atomic_uint64_t kernel_tls_;
+};
+
+#endif//MYMUDUO_TLSCONTEXT_H
@@ -0,0 +1,72 @@
+#ifndef MYMUDUO_TLSFILTER_H
+#define MYMUDUO_TLSFILTER_H
+
+#include "base/noncopyable.h"
+#include <string>
+#include <sys/types.h>
+
+struct ssl_st;
+
+class Buffer;
+
+class TlsContext;
+
+/* TcpConnection的TLS层，由TcpConnection::startTls创建
+ * SSL直接读写非阻塞socket（而不是内存BIO），这样OpenSSL可以在握手后把socket切换为kTLS，
+ * 之后的SSL_read/SSL_write由内核加解密，用户态不再复制
+ * read/write返回-1且*saved_errno为EAGAIN时表示需要等待socket事件，wantWrite()说明等的是否是可写
+ * */
+
+class TlsFilter : private noncopyable {
+public:
+    /* 客户端模式时session_key用于会话缓存，server_name非空时用于SNI和证书校验，为空时按对端IP校验证书 */
+    TlsFilter(TlsContext *context, int fd, const std::string &server_name, std::string session_key);
+
+    ~TlsFilter();
+
+    /* 推进握手，返回1完成，0进行中，-1失败 */
+    int handshake();
+
+    bool handshakeDone() const {
+        return handshake_done_;
+    }
+
+    bool wantWrite() const {
+        return want_write_;
+    }
+
+    /* 读出所有可读的明文追加到buf，返回读到的字节数，0为对端关闭 */
+    ssize_t read(Buffer *buf, int *saved_errno);
+
+    /* 返回写入的明文字节数，可能少于len */
+    ssize_t write(const char *data, size_t len, int *saved_errno);
+
+    /* 发送close_notify，不等待对端回复 */
+    void shutdown();
+
+    bool resumed() const;
+
+    bool kernelSend() const {
+        return kernel_send_;
+    }
+
+    bool kernelReceive() const {
+        return kernel_receive_;
+    }
+
+private:
+    friend class TlsContext;
+
+    //把SSL的返回值转换为errno语义
+    ssize_t translateError(int ret, int *saved_errno);
+
+    TlsContext *context_;
+    ssl_st *ssl_;
+    std::string session_key_;
+    bool handshake_done_;
+    bool want_write_;
+    bool kernel_send_;
+    bool kernel_receive_;
+};
+
+#endif//MYMUDUO_TLSFILTER_H
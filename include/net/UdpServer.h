@@ -0,0 +1,81 @@
+#ifndef MYMUDUO_UDPSERVER_H
+#define MYMUDUO_UDPSERVER_H
+
+#include "EventLoopThreadPool.h"
+#include "InetAddress.h"
+#include "UdpSocket.h"
+#include "base/noncopyable.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class EventLoop;
+
+/* 每个io loop一个UdpSocket，以SO_REUSEPORT绑定同一地址，由内核按源地址哈希分散数据报，
+ * 同一对端的数据报总是落在同一个loop；setThreadNum(0)时只在base loop上收发
+ * MessageCallback在各自的io线程中执行，回复用参数中的UdpSocket发送
+ * */
+
+class UdpServer : private noncopyable {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop *)>;
+
+    /* listen_addr端口不能为0，否则各loop的socket会绑定到不同端口 */
+    UdpServer(EventLoop *loop, const InetAddress &listen_addr, std::string name);
+
+    ~UdpServer();
+
+    const std::string &name() const {
+        return name_;
+    }
+
+    void setThreadNum(int num);
+
+    void setThreadAffinity(std::vector<CpuAffinity::CpuSet> cpu_sets);
+
+    void setThreadInitCallback(const ThreadInitCallback &cb) {
+        thread_init_callback_ = cb;
+    }
+
+    void setMessageCallback(const UdpSocket::MessageCallback &cb) {
+        message_callback_ = cb;
+    }
+
+    void setMaxDatagramSize(size_t size) {
+        max_datagram_size_ = size;
+    }
+
+    /* start之前调用，内核不支持时各socket自动关闭 */
+    void enableGro(bool on) {
+        gro_ = on;
+    }
+
+    void enableGso(bool on) {
+        gso_ = on;
+    }
+
+    void start();
+
+    uint64_t receivedDatagrams() const;
+
+    uint64_t sentDatagrams() const;
+
+    uint64_t droppedDatagrams() const;
+
+private:
+    EventLoop *loop_;
+    const InetAddress listen_addr_;
+    const std::string name_;
+    std::shared_ptr<EventLoopThreadPool> thread_pool_;
+    UdpSocket::MessageCallback message_callback_;
+    ThreadInitCallback thread_init_callback_;
+    size_t max_datagram_size_;
+    bool gro_;
+    bool gso_;
+    std::atomic_int started_;
+    std::vector<std::unique_ptr<UdpSocket>> sockets_;
+};
+
+#endif//MYMUDUO_UDPSERVER_H
@@ -0,0 +1,139 @@
+#ifndef MYMUDUO_UDPSOCKET_H
+#define MYMUDUO_UDPSOCKET_H
+
+#include "Buffer.h"
+#include "Channel.h"
+#include "InetAddress.h"
+#include "Socket.h"
+#include "base/Timestamp.h"
+#include "base/noncopyable.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <sys/socket.h>
+#include <vector>
+
+class EventLoop;
+
+/* 非阻塞UDP socket，注册在一个EventLoop上，除统计外只在该loop线程中使用，也要在该线程中析构
+ * 接收：可读时用recvmmsg一次收多个数据报；开启GRO时内核把同一流中同样长度的数据报合并到一个缓冲，
+ *      这里按段长拆开，MessageCallback仍然每次拿到一个数据报，data只在回调期间有效
+ * 发送：send把数据报追加到发送批中，在本批接收回调结束后（回调外调用时在本轮loop结束前）用sendmmsg发出；
+ *      开启GSO时，连续发往同一地址、长度相同的数据报（最后一个可以更短）合并为一条消息，由内核或网卡分段
+ * socket发送缓冲满时等待可写，积压超过setMaxPendingBytes后新数据报直接丢弃并计数
+ * */
+
+class UdpSocket : private noncopyable {
+public:
+    using MessageCallback = std::function<void(UdpSocket *, const char *, size_t, const InetAddress &, Timestamp)>;
+
+    static constexpr int BatchSize = 64;
+    static constexpr size_t DefaultMaxDatagramSize = 2048;
+    static constexpr size_t GroBufferSize = 65536;
+
+    /* bind_addr端口为0时由内核选择，用于客户端 */
+    UdpSocket(EventLoop *loop, const InetAddress &bind_addr, bool reuse_port = false);
+
+    ~UdpSocket();
+
+    void setMessageCallback(MessageCallback cb) {
+        message_callback_ = std::move(cb);
+    }
+
+    /* start之前调用，超过该长度的数据报被截断后丢弃并计数 */
+    void setMaxDatagramSize(size_t size) {
+        max_datagram_size_ = size;
+    }
+
+    void setMaxPendingBytes(size_t bytes) {
+        max_pending_bytes_ = bytes;
+    }
+
+    /* start之前调用，内核不支持时返回false并保持关闭 */
+    bool enableGro(bool on);
+
+    bool enableGso(bool on);
+
+    bool groEnabled() const {
+        return gro_;
+    }
+
+    bool gsoEnabled() const {
+        return gso_;
+    }
+
+    void start();
+
+    /* 在loop线程中调用，len不超过65507 */
+    void send(const void *data, size_t len, const InetAddress &peer);
+
+    /* 立即发出发送批中的数据报 */
+    void flush();
+
+    EventLoop *getLoop() const {
+        return loop_;
+    }
+
+    int fd() const {
+        return socket_.getFd();
+    }
+
+    InetAddress localAddress() const;
+
+    uint64_t receivedDatagrams() const {
+        return received_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t sentDatagrams() const {
+        return sent_.load(std::memory_order_relaxed);
+    }
+
+    /* 截断、积压过多或发送出错而丢弃的数据报 */
+    uint64_t droppedDatagrams() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Datagram {
+        size_t len;
+        sockaddr_in peer;
+    };
+
+    void handleRead(Timestamp receive_time);
+
+    void handleWrite();
+
+    //返回false表示socket发送缓冲已满
+    bool sendBatch();
+
+    //从first开始可以合并为一条GSO消息的数据报个数
+    size_t gsoRun(size_t first, size_t *bytes) const;
+
+    EventLoop *loop_;
+    Socket socket_;
+    Channel channel_;
+    MessageCallback message_callback_;
+    size_t max_datagram_size_;
+    size_t max_pending_bytes_;
+    bool gro_;
+    bool gso_;
+    bool in_read_;
+    bool flush_queued_;
+    std::shared_ptr<UdpSocket *> self_;//排队的flush持有weak_ptr，socket析构后不再执行
+
+    size_t slot_size_;
+    std::unique_ptr<char[]> recv_buffers_;
+    std::vector<mmsghdr> recv_msgs_;
+    std::vector<iovec> recv_iovs_;
+    std::vector<sockaddr_in> recv_addrs_;
+    std::unique_ptr<char[]> recv_controls_;
+
+    Buffer send_buffer_;
+    std::vector<Datagram> pending_;
+
+    std::atomic_uint64_t received_;
+    std::atomic_uint64_t sent_;
+    std::atomic_uint64_t dropped_;
+};
+
+#endif//MYMUDUO_UDPSOCKET_H
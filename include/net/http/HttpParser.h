@@ -0,0 +1,89 @@
+#ifndef MYMUDUO_HTTPPARSER_H
+#define MYMUDUO_HTTPPARSER_H
+
+#include "base/copyable.h"
+#include "net/http/HttpRequest.h"
+#include <cstddef>
+#include <cstdint>
+
+class Buffer;
+
+/* 增量的HTTP/1.1请求解析器，直接在Buffer上解析，不分配内存
+ * 每次数据到达时只继续扫描新数据：请求头查找\r\n\r\n从上次的位置继续，请求体按Content-Length或chunked增量处理
+ * chunked的数据块在Buffer内原地前移拼接，去掉块头和块尾；块头、块尾和trailer合计不超过max_header_size
+ * 返回Complete后request的各字段指向buf，处理完后buf->retrieve(requestSize())并reset()，
+ * 同一Buffer中流水线发来的下一个请求可以接着解析
+ * */
+
+class HttpParser : public copyable {
+public:
+    enum Result {
+        Incomplete,
+        Complete,
+        Error,
+    };
+
+    explicit HttpParser(size_t max_header_size = 8 * 1024, size_t max_body_size = 1024 * 1024)
+        : max_header_size_(max_header_size), max_body_size_(max_body_size) {}
+
+    Result parse(Buffer *buf, HttpRequest *request);
+
+    /* Complete后本请求在Buffer中占的字节数 */
+    size_t requestSize() const {
+        return request_size_;
+    }
+
+    /* Error时应回复的状态码 */
+    int errorStatus() const {
+        return error_status_;
+    }
+
+    void reset() {
+        state_ = ExpectHeaders;
+        scanned_ = 0;
+        header_size_ = 0;
+        content_length_ = 0;
+        chunked_ = false;
+        raw_pos_ = 0;
+        decoded_size_ = 0;
+        chunk_remaining_ = 0;
+        request_size_ = 0;
+        error_status_ = 0;
+    }
+
+private:
+    enum State {
+        ExpectHeaders,
+        ExpectBody,
+        ExpectChunkSize,
+        ExpectChunkData,
+        ExpectChunkTrailers,
+    };
+
+    Result fail(int status) {
+        error_status_ = status;
+        return Error;
+    }
+
+    //解析请求行和请求头，确定请求体的长度或chunked
+    Result parseHeaders(const char *begin, size_t len, HttpRequest *request);
+
+    Result parseChunked(Buffer *buf);
+
+    Result complete(Buffer *buf, HttpRequest *request, size_t body_size, size_t request_size);
+
+    size_t max_header_size_;
+    size_t max_body_size_;
+    State state_ = ExpectHeaders;
+    size_t scanned_ = 0;    //已扫描过的请求头字节
+    size_t header_size_ = 0;//含结尾的\r\n\r\n
+    uint64_t content_length_ = 0;
+    bool chunked_ = false;
+    size_t raw_pos_ = 0;        //chunked时下一个未处理的原始字节，相对peek()
+    size_t decoded_size_ = 0;   //已拼接到header_size_之后的请求体字节
+    uint64_t chunk_remaining_ = 0;
+    size_t request_size_ = 0;
+    int error_status_ = 0;
+};
+
+#endif//MYMUDUO_HTTPPARSER_H
@@ -0,0 +1,103 @@
+#ifndef MYMUDUO_HTTPREQUEST_H
+#define MYMUDUO_HTTPREQUEST_H
+
+#include "base/copyable.h"
+#include <cstddef>
+#include <string_view>
+#include <strings.h>
+
+/* 解析后的请求，所有字段都是指向输入Buffer的string_view，不复制
+ * 只在HttpCallback中有效，回调返回后请求所占的数据从Buffer中取走
+ * */
+
+class HttpRequest : public copyable {
+public:
+    enum Method {
+        Invalid,
+        Get,
+        Head,
+        Post,
+        Put,
+        Delete,
+        Options,
+        Patch,
+    };
+
+    enum Version {
+        Unknown,
+        Http10,
+        Http11,
+    };
+
+    struct Header {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    static constexpr size_t MaxHeaders = 64;
+
+    Method method() const {
+        return method_;
+    }
+
+    std::string_view methodString() const {
+        return method_string_;
+    }
+
+    /* ?之前的部分 */
+    std::string_view path() const {
+        return path_;
+    }
+
+    /* ?之后的部分，不含? */
+    std::string_view query() const {
+        return query_;
+    }
+
+    Version version() const {
+        return version_;
+    }
+
+    /* 名字不区分大小写，没有时返回空 */
+    std::string_view getHeader(std::string_view name) const {
+        for (size_t i = 0; i < num_headers_; ++i) {
+            if (headers_[i].name.size() == name.size() &&
+                ::strncasecmp(headers_[i].name.data(), name.data(), name.size()) == 0) {
+                return headers_[i].value;
+            }
+        }
+        return {};
+    }
+
+    const Header *headers() const {
+        return headers_;
+    }
+
+    size_t numHeaders() const {
+        return num_headers_;
+    }
+
+    /* chunked的请求体已在Buffer中原地拼接成连续的一段 */
+    std::string_view body() const {
+        return body_;
+    }
+
+    bool keepAlive() const {
+        return keep_alive_;
+    }
+
+private:
+    friend class HttpParser;
+
+    Method method_ = Invalid;
+    std::string_view method_string_;
+    std::string_view path_;
+    std::string_view query_;
+    Version version_ = Unknown;
+    Header headers_[MaxHeaders];
+    size_t num_headers_ = 0;
+    std::string_view body_;
+    bool keep_alive_ = false;
+};
+
+#endif//MYMUDUO_HTTPREQUEST_H
@@ -0,0 +1,73 @@
+#ifndef MYMUDUO_HTTPRESPONSE_H
+#define MYMUDUO_HTTPRESPONSE_H
+
+#include "base/copyable.h"
+#include <string>
+#include <string_view>
+
+class Buffer;
+
+/* 响应直接序列化到输出Buffer，自动加上Content-Length、Connection和Date（每线程每秒格式化一次）
+ * 101时只加Connection: Upgrade和Date，不带响应体
+ * */
+
+class HttpResponse : public copyable {
+public:
+    explicit HttpResponse(bool close_connection)
+        : status_code_(200), reason_("OK"), close_connection_(close_connection) {}
+
+    /* reason为空时用标准短语（静态字符串，不复制），否则复制一份 */
+    void setStatus(int code, std::string_view reason = {}) {
+        status_code_ = code;
+        reason_ = reasonPhrase(code);
+        custom_reason_.assign(reason.data(), reason.size());
+    }
+
+    int statusCode() const {
+        return status_code_;
+    }
+
+    void setCloseConnection(bool on) {
+        close_connection_ = on;
+    }
+
+    bool closeConnection() const {
+        return close_connection_;
+    }
+
+    void setContentType(std::string_view type) {
+        addHeader("Content-Type", type);
+    }
+
+    void addHeader(std::string_view name, std::string_view value) {
+        headers_.append(name.data(), name.size());
+        headers_.append(": ", 2);
+        headers_.append(value.data(), value.size());
+        headers_.append("\r\n", 2);
+    }
+
+    void setBody(std::string body) {
+        body_ = std::move(body);
+    }
+
+    /* 不复制，data需在appendToBuffer之前一直有效，如静态内容 */
+    void setBodyView(std::string_view body) {
+        body_view_ = body;
+    }
+
+    /* HEAD请求时include_body为false，Content-Length仍为实际长度 */
+    void appendToBuffer(Buffer *output, bool include_body = true) const;
+
+    static std::string_view reasonPhrase(int code);
+
+private:
+    int status_code_;
+    std::string_view reason_;//只指向reasonPhrase返回的静态字符串，复制对象时仍有效
+    std::string custom_reason_;
+    bool close_connection_;
+    std::string headers_;
+    std::string body_;
+    std::string_view body_view_;
+};
+
+#endif//MYMUDUO_HTTPRESPONSE_H
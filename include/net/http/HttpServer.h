@@ -0,0 +1,65 @@
+#ifndef MYMUDUO_HTTPSERVER_H
+#define MYMUDUO_HTTPSERVER_H
+
+#include "base/noncopyable.h"
+#include "net/TcpServer.h"
+#include "net/http/HttpParser.h"
+#include "net/http/HttpRequest.h"
+#include "net/http/HttpResponse.h"
+#include <functional>
+
+/* HTTP/1.1服务器，支持keep-alive和流水线
+ * 一次读到的多个请求依次解析、调用回调，响应按请求顺序写入同一个输出Buffer，最后一次send
+ * 回调在io线程中同步执行，需要耗时计算时应自行offload并保证同一连接上的顺序（见ComputeSequencer）
+ * 解析出错时回复相应的4xx/5xx并关闭连接；决定关闭连接后丢弃之后收到的数据，不再调用回调
+ * */
+
+class HttpServer : private noncopyable {
+public:
+    using HttpCallback = std::function<void(const HttpRequest &, HttpResponse *)>;
+
+    HttpServer(EventLoop *loop, const InetAddress &listen_addr, std::string name,
+               TcpServer::Option option = TcpServer::NoReusePort);
+
+    void setHttpCallback(HttpCallback cb) {
+        http_callback_ = std::move(cb);
+    }
+
+    void setThreadNum(int num) {
+        server_.setThreadNum(num);
+    }
+
+    void setMaxHeaderSize(size_t size) {
+        max_header_size_ = size;
+    }
+
+    void setMaxBodySize(size_t size) {
+        max_body_size_ = size;
+    }
+
+    TcpServer *server() {
+        return &server_;
+    }
+
+    void start() {
+        server_.start();
+    }
+
+private:
+    //保存在连接的context中
+    struct Session {
+        HttpParser parser;
+        bool closing = false;
+    };
+
+    void onConnection(const TcpConnectionPtr &conn);
+
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time);
+
+    TcpServer server_;
+    HttpCallback http_callback_;
+    size_t max_header_size_;
+    size_t max_body_size_;
+};
+
+#endif//MYMUDUO_HTTPSERVER_H
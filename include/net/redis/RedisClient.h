@@ -0,0 +1,95 @@
+#ifndef MYMUDUO_REDISCLIENT_H
+#define MYMUDUO_REDISCLIENT_H
+
+#include "base/noncopyable.h"
+#include "net/TcpClient.h"
+#include "net/redis/RespParser.h"
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+/* 流水线的Redis客户端：一条连接，命令不等回复连续发送，回复按先进先出与命令匹配
+ * 同一轮loop中发出的命令编码到同一个输出Buffer，在本轮末尾一次send
+ * 连接建立之前的命令暂存，连接后发送；连接断开时所有未回复的命令以Disconnected结束
+ * RESP3的Push消息不参与匹配，交给PushCallback
+ * 回调都在loop线程中执行，reply只在回调期间有效；服务端错误以reply.isError()表示
+ * */
+
+class RedisClient : private noncopyable {
+public:
+    enum Status {
+        Ok,
+        Disconnected,//reply为Null
+    };
+
+    using ReplyCallback = std::function<void(Status, const RespValue &reply)>;
+    using PushCallback = std::function<void(const RespValue &push)>;
+
+    RedisClient(EventLoop *loop, const InetAddress &server_addr, const std::string &name);
+
+    void connect() {
+        client_.connect();
+    }
+
+    void disconnect() {
+        client_.disconnect();
+    }
+
+    void enableRetry() {
+        client_.enableRetry();
+    }
+
+    void setConnectionCallback(ConnectionCallback cb) {
+        connection_callback_ = std::move(cb);
+    }
+
+    void setPushCallback(PushCallback cb) {
+        push_callback_ = std::move(cb);
+    }
+
+    /* 可以在任意线程中调用，非loop线程时复制参数；cb可以为空 */
+    void command(std::initializer_list<std::string_view> args, ReplyCallback cb) {
+        command(args.begin(), args.size(), std::move(cb));
+    }
+
+    void command(const std::vector<std::string_view> &args, ReplyCallback cb) {
+        command(args.data(), args.size(), std::move(cb));
+    }
+
+    /* 已发出尚未收到回复的命令数，只在loop线程中有意义 */
+    size_t pending() const {
+        return callbacks_.size();
+    }
+
+    EventLoop *getLoop() const {
+        return loop_;
+    }
+
+    /* 编码为元素都是BulkString的Array */
+    static void encodeCommand(Buffer *buf, const std::string_view *args, size_t count);
+
+private:
+    void command(const std::string_view *args, size_t count, ReplyCallback cb);
+
+    void commandInLoop(const std::string_view *args, size_t count, ReplyCallback cb);
+
+    void flush();
+
+    void onConnection(const TcpConnectionPtr &conn);
+
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf);
+
+    EventLoop *loop_;
+    TcpClient client_;
+    RespParser parser_;
+    ConnectionCallback connection_callback_;
+    PushCallback push_callback_;
+    TcpConnectionPtr conn_;//只在loop线程中访问
+    std::deque<ReplyCallback> callbacks_;
+    Buffer output_;
+    bool flush_queued_;
+};
+
+#endif//MYMUDUO_REDISCLIENT_H
@@ -0,0 +1,137 @@
+#ifndef MYMUDUO_RESPPARSER_H
+#define MYMUDUO_RESPPARSER_H
+
+#include "base/copyable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class Buffer;
+
+class RespParser;
+
+/* RESP回复中的一个值，指向RespParser内部的节点和输入Buffer，只在下一次parse/reset之前有效
+ * 聚合类型（Array、Map、Set、Push）的元素按顺序展开，Map的键值交替出现，size()为元素个数
+ * RESP3的Attribute不计入元素，读取时被跳过
+ * */
+class RespValue : public copyable {
+public:
+    enum Type : char {
+        SimpleString = '+',
+        Error = '-',
+        Integer = ':',
+        BulkString = '$',
+        Array = '*',
+        Null = '_',
+        Boolean = '#',
+        Double = ',',
+        BigNumber = '(',
+        BulkError = '!',
+        VerbatimString = '=',
+        Map = '%',
+        Set = '~',
+        Attribute = '|',
+        Push = '>',
+    };
+
+    Type type() const;
+
+    /* RESP3的Null以及RESP2的$-1、*-1 */
+    bool isNull() const;
+
+    bool isError() const {
+        return type() == Error || type() == BulkError;
+    }
+
+    bool isAggregate() const {
+        Type t = type();
+        return t == Array || t == Map || t == Set || t == Push || t == Attribute;
+    }
+
+    /* 字符串类型的内容，Double和BigNumber为原始文本 */
+    std::string_view str() const;
+
+    /* Integer的值，Boolean时为0或1 */
+    int64_t integer() const;
+
+    double toDouble() const;
+
+    size_t size() const;
+
+    RespValue operator[](size_t i) const;
+
+private:
+    friend class RespParser;
+
+    RespValue(const RespParser *parser, size_t index) : parser_(parser), index_(index) {}
+
+    const RespParser *parser_;
+    size_t index_;
+};
+
+/* 增量的RESP2/RESP3回复解析器，直接在Buffer上解析
+ * 每次数据到达时从上次停下的位置继续，已解析的值只记录相对可读区起点的偏移，Buffer扩容或整理后仍然有效
+ * 返回Complete后reply()指向buf，处理完后buf->retrieve(replySize())并reset()，接着解析流水线中的下一个回复
+ * 同一解析器也可以解析客户端发来的命令（元素为BulkString的Array）
+ * */
+class RespParser : public copyable {
+public:
+    enum Result {
+        Incomplete,
+        Complete,
+        Error,
+    };
+
+    explicit RespParser(size_t max_bulk_size = 512 * 1024 * 1024, size_t max_elements = 1024 * 1024)
+        : max_bulk_size_(max_bulk_size), max_elements_(max_elements), pos_(0), root_(0), base_(nullptr) {}
+
+    Result parse(Buffer *buf);
+
+    RespValue reply() const {
+        return RespValue(this, root_);
+    }
+
+    /* Complete后本回复在Buffer中占的字节数 */
+    size_t replySize() const {
+        return pos_;
+    }
+
+    void reset() {
+        pos_ = 0;
+        nodes_.clear();
+        stack_.clear();
+        base_ = nullptr;
+    }
+
+private:
+    friend class RespValue;
+
+    struct Node {
+        RespValue::Type type;
+        bool null;
+        uint32_t elements;
+        uint32_t span;//以本节点为根的子树占的节点数
+        int64_t integer;
+        size_t offset;//相对可读区起点
+        size_t length;
+    };
+
+    struct Frame {
+        size_t node;
+        size_t remaining;
+    };
+
+    static constexpr size_t MaxLineSize = 64 * 1024;
+    static constexpr size_t MaxDepth = 128;
+
+    size_t max_bulk_size_;
+    size_t max_elements_;
+    size_t pos_;
+    size_t root_;
+    const char *base_;
+    std::vector<Node> nodes_;
+    std::vector<Frame> stack_;
+};
+
+#endif//MYMUDUO_RESPPARSER_H
@@ -0,0 +1,89 @@
+#ifndef MYMUDUO_RPCCLIENT_H
+#define MYMUDUO_RPCCLIENT_H
+
+#include "base/noncopyable.h"
+#include "net/LengthHeaderCodec.h"
+#include "net/TcpClient.h"
+#include "net/TimerId.h"
+#include "net/rpc/RpcMessage.h"
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+/* 多路复用的RPC客户端：所有调用共用一条连接，每个请求带递增的id，响应按id匹配，可以乱序到达
+ * 同一轮loop中发出的请求写入同一个输出Buffer，在本轮末尾一次send
+ * 每个请求可以有自己的超时，用loop的定时器实现；大量短超时请求时可以给loop换用TimerWheel
+ * 连接建立之前发出的请求暂存，连接后发送；连接断开时所有未完成的请求以Disconnected结束
+ * 回调都在loop线程中执行，且每个请求只回调一次
+ * */
+
+class RpcClient : private noncopyable {
+public:
+    enum Status {
+        Ok,
+        Error,       //服务端回复了错误，payload为错误信息
+        Timeout,
+        Disconnected,
+    };
+
+    using ResponseCallback = std::function<void(Status, std::string_view payload)>;
+
+    RpcClient(EventLoop *loop, const InetAddress &server_addr, const std::string &name);
+
+    void connect() {
+        client_.connect();
+    }
+
+    void disconnect() {
+        client_.disconnect();
+    }
+
+    void enableRetry() {
+        client_.enableRetry();
+    }
+
+    void setConnectionCallback(ConnectionCallback cb) {
+        connection_callback_ = std::move(cb);
+    }
+
+    /* timeout为秒数，小于等于0时不超时；可以在任意线程中调用，非loop线程时复制参数 */
+    void call(std::string_view method, std::string_view payload, ResponseCallback cb, double timeout = 0);
+
+    /* 未完成的请求数，只在loop线程中有意义 */
+    size_t pending() const {
+        return pending_.size();
+    }
+
+    EventLoop *getLoop() const {
+        return loop_;
+    }
+
+private:
+    struct Call {
+        ResponseCallback callback;
+        TimerId timer;
+        bool has_timer;
+    };
+
+    void callInLoop(std::string_view method, std::string_view payload, ResponseCallback cb, double timeout);
+
+    void flush();
+
+    void onConnection(const TcpConnectionPtr &conn);
+
+    void onFrame(const TcpConnectionPtr &conn, std::string_view frame);
+
+    void onTimeout(uint64_t id);
+
+    EventLoop *loop_;
+    TcpClient client_;
+    LengthHeaderCodec codec_;
+    ConnectionCallback connection_callback_;
+    TcpConnectionPtr conn_;//只在loop线程中访问
+    std::unordered_map<uint64_t, Call> pending_;
+    uint64_t next_id_;
+    Buffer output_;
+    bool flush_queued_;
+};
+
+#endif//MYMUDUO_RPCCLIENT_H
@@ -0,0 +1,38 @@
+#ifndef MYMUDUO_RPCMESSAGE_H
+#define MYMUDUO_RPCMESSAGE_H
+
+#include "base/copyable.h"
+#include <cstdint>
+#include <string_view>
+
+class Buffer;
+
+/* RPC消息，外层用LengthHeaderCodec分帧，帧内依次为（网络序）：
+ *   int64 id | int8 kind | int16 方法名长度 | 方法名 | 负载
+ * 响应的id与请求相同，方法名为空；同一连接上的多个请求可以交错，响应可以乱序返回
+ * decode得到的method、payload指向帧，只在帧回调期间有效
+ * */
+
+class RpcMessage : public copyable {
+public:
+    enum Kind : uint8_t {
+        Request,
+        Response,
+        Error,//payload为错误信息
+    };
+
+    static constexpr size_t HeaderLen = 8 + 1 + 2;
+
+    uint64_t id = 0;
+    Kind kind = Request;
+    std::string_view method;
+    std::string_view payload;
+
+    /* 把含长度前缀的完整帧追加到buf，方法名超过65535字节时截断 */
+    static void encode(Buffer *buf, uint64_t id, Kind kind, std::string_view method, std::string_view payload);
+
+    /* 帧格式错误时返回false */
+    static bool decode(std::string_view frame, RpcMessage *message);
+};
+
+#endif//MYMUDUO_RPCMESSAGE_H
@@ -0,0 +1,79 @@
+#ifndef MYMUDUO_RPCSERVER_H
+#define MYMUDUO_RPCSERVER_H
+
+#include "base/noncopyable.h"
+#include "net/LengthHeaderCodec.h"
+#include "net/TcpServer.h"
+#include "net/rpc/RpcMessage.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+/* 多路复用的RPC服务器：同一连接上可以同时有任意多个未完成的请求，按请求id回复
+ * 方法回调在io线程中执行，可以立即回复，也可以保存Responder在任意线程、任意时间回复，响应因此可以乱序
+ * 一次读到的请求中同步回复的响应合并为一次send；异步回复时每个响应单独send
+ * 未注册的方法回复Error
+ * */
+
+class RpcServer : private noncopyable {
+public:
+    /* 可复制，只回复一次；连接已关闭时回复被丢弃 */
+    class Responder {
+    public:
+        Responder(std::weak_ptr<TcpConnection> conn, uint64_t id) : conn_(std::move(conn)), id_(id) {}
+
+        void reply(std::string_view payload) const {
+            send(RpcMessage::Response, payload);
+        }
+
+        void fail(std::string_view message) const {
+            send(RpcMessage::Error, message);
+        }
+
+        uint64_t id() const {
+            return id_;
+        }
+
+    private:
+        void send(RpcMessage::Kind kind, std::string_view payload) const;
+
+        std::weak_ptr<TcpConnection> conn_;
+        uint64_t id_;
+    };
+
+    using MethodCallback = std::function<void(const TcpConnectionPtr &, std::string_view payload, const Responder &)>;
+
+    RpcServer(EventLoop *loop, const InetAddress &listen_addr, std::string name,
+              TcpServer::Option option = TcpServer::NoReusePort);
+
+    /* 需在start之前注册 */
+    void registerMethod(std::string method, MethodCallback cb) {
+        methods_[std::move(method)] = std::move(cb);
+    }
+
+    void setThreadNum(int num) {
+        server_.setThreadNum(num);
+    }
+
+    void setMaxFrameSize(size_t size);
+
+    TcpServer *server() {
+        return &server_;
+    }
+
+    void start() {
+        server_.start();
+    }
+
+private:
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time);
+
+    void onFrame(const TcpConnectionPtr &conn, std::string_view frame);
+
+    TcpServer server_;
+    std::unique_ptr<LengthHeaderCodec> codec_;
+    std::map<std::string, MethodCallback, std::less<>> methods_;//less<>允许用string_view查找
+};
+
+#endif//MYMUDUO_RPCSERVER_H
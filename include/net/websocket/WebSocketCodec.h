@@ -0,0 +1,100 @@
+#ifndef MYMUDUO_WEBSOCKETCODEC_H
+#define MYMUDUO_WEBSOCKETCODEC_H
+
+#include "base/copyable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class Buffer;
+
+/* WebSocket（RFC 6455）帧编解码，直接在Buffer上进行
+ * 解码：收齐一帧后原地去掩码（SSE2一次16字节），分片消息的后续分片原地前移拼接在前一分片之后，
+ *      消息和控制帧都以指向Buffer的string_view交出，处理完后调用consume
+ *      控制帧可以夹在分片之间，先于所在的消息交出；不校验Text消息的UTF-8
+ * 编码：encode把Buffer中的全部可读数据作为负载，帧头写入预留区，负载不移动
+ * */
+
+class WebSocketCodec : public copyable {
+public:
+    enum Opcode : uint8_t {
+        Continuation = 0x0,
+        Text = 0x1,
+        Binary = 0x2,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA,
+    };
+
+    enum Result {
+        Incomplete,
+        Message,//完整的Text或Binary消息
+        Control,//Close、Ping或Pong
+        Error,
+    };
+
+    enum CloseCode : uint16_t {
+        NormalClosure = 1000,
+        GoingAway = 1001,
+        ProtocolError = 1002,
+        PolicyViolation = 1008,
+        MessageTooBig = 1009,
+    };
+
+    static constexpr size_t MaxHeaderLen = 14;
+
+    /* 服务端解析客户端的帧时expect_masked为true，客户端为false */
+    explicit WebSocketCodec(bool expect_masked, size_t max_message_size = 16 * 1024 * 1024)
+        : expect_masked_(expect_masked), max_message_size_(max_message_size) {}
+
+    Result parse(Buffer *buf);
+
+    /* Message或Control时有效，直到consume */
+    Opcode opcode() const {
+        return opcode_;
+    }
+
+    std::string_view payload() const {
+        return payload_;
+    }
+
+    /* 从Buffer中取走已处理的数据；分片消息未收完时只跳过夹在中间的控制帧 */
+    void consume(Buffer *buf);
+
+    /* Error时应发送的关闭码 */
+    CloseCode errorCode() const {
+        return error_code_;
+    }
+
+    /* 把buf中的全部可读数据编码为一帧；mask_key非空时原地加掩码（客户端发送） */
+    static void encode(Buffer *buf, Opcode opcode, bool fin = true, const uint8_t *mask_key = nullptr);
+
+    /* 把一个完整的帧追加到buf */
+    static void appendFrame(Buffer *buf, Opcode opcode, std::string_view payload, const uint8_t *mask_key = nullptr);
+
+    /* 掩码与去掩码相同，data从负载第一个字节开始 */
+    static void mask(char *data, size_t len, const uint8_t *mask_key);
+
+private:
+    static size_t writeHeader(uint8_t *header, Opcode opcode, bool fin, size_t len, const uint8_t *mask_key);
+
+    Result fail(CloseCode code) {
+        error_code_ = code;
+        return Error;
+    }
+
+    bool expect_masked_;
+    size_t max_message_size_;
+    size_t scan_ = 0;     //下一帧相对可读区起点的偏移
+    size_t frame_end_ = 0;//当前控制帧之后的偏移
+    bool in_message_ = false;
+    Opcode message_opcode_ = Text;
+    size_t message_begin_ = 0;//分片消息拼接后的负载
+    size_t message_len_ = 0;
+    Result last_ = Incomplete;
+    Opcode opcode_ = Text;
+    std::string_view payload_;
+    CloseCode error_code_ = ProtocolError;
+};
+
+#endif//MYMUDUO_WEBSOCKETCODEC_H
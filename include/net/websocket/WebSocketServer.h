@@ -0,0 +1,124 @@
+#ifndef MYMUDUO_WEBSOCKETSERVER_H
+#define MYMUDUO_WEBSOCKETSERVER_H
+
+#include "base/noncopyable.h"
+#include "net/TcpServer.h"
+#include "net/http/HttpRequest.h"
+#include "net/websocket/WebSocketCodec.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/* WebSocket服务器：先按HTTP/1.1处理升级请求（RFC 6455第4节），成功后同一连接改用WebSocketCodec
+ * 自动回复Ping，收到Close时回复Close后关闭；协议错误时发送相应的关闭码后关闭
+ * 回调都在io线程中执行；send、close可以在任意线程中调用
+ * 广播：makeFrame把消息序列化一次，各连接共享同一份帧，每个io线程只投递一个任务
+ * */
+
+class WebSocketServer : private noncopyable {
+public:
+    using AcceptCallback = std::function<bool(const HttpRequest &)>;
+    using OpenCallback = std::function<void(const TcpConnectionPtr &)>;
+    using MessageCallback = std::function<void(const TcpConnectionPtr &, std::string_view, WebSocketCodec::Opcode)>;
+    using CloseCallback = std::function<void(const TcpConnectionPtr &)>;
+    using Frame = std::shared_ptr<const std::string>;
+
+    WebSocketServer(EventLoop *loop, const InetAddress &listen_addr, std::string name,
+                    TcpServer::Option option = TcpServer::NoReusePort);
+
+    /* 握手时调用，返回false时回复403，如按path或Origin过滤 */
+    void setAcceptCallback(AcceptCallback cb) {
+        accept_callback_ = std::move(cb);
+    }
+
+    /* 101已发出后调用，可以立即发送消息 */
+    void setOpenCallback(OpenCallback cb) {
+        open_callback_ = std::move(cb);
+    }
+
+    /* message只在回调期间有效 */
+    void setMessageCallback(MessageCallback cb) {
+        message_callback_ = std::move(cb);
+    }
+
+    /* 已打开的连接断开时调用 */
+    void setCloseCallback(CloseCallback cb) {
+        close_callback_ = std::move(cb);
+    }
+
+    void setThreadNum(int num) {
+        server_.setThreadNum(num);
+    }
+
+    void setMaxMessageSize(size_t size) {
+        max_message_size_ = size;
+    }
+
+    TcpServer *server() {
+        return &server_;
+    }
+
+    void start() {
+        server_.start();
+    }
+
+    static void send(const TcpConnectionPtr &conn, std::string_view message,
+                     WebSocketCodec::Opcode opcode = WebSocketCodec::Text);
+
+    /* buf中的全部可读数据作为一条消息，帧头写入预留区后发送，buf被清空 */
+    static void send(const TcpConnectionPtr &conn, Buffer *buf, WebSocketCodec::Opcode opcode = WebSocketCodec::Text);
+
+    /* 发送Close帧，收到对端的Close后关闭连接 */
+    static void close(const TcpConnectionPtr &conn, uint16_t code = WebSocketCodec::NormalClosure,
+                      std::string_view reason = {});
+
+    static Frame makeFrame(std::string_view message, WebSocketCodec::Opcode opcode = WebSocketCodec::Text);
+
+    /* 其他线程中调用时只复制frame的引用 */
+    static void sendFrame(const TcpConnectionPtr &conn, const Frame &frame);
+
+    /* 发给所有已打开的连接 */
+    void broadcast(const Frame &frame);
+
+    size_t numOpenConnections() const;
+
+private:
+    //每个io线程中已打开的连接，只在该线程中访问
+    struct LoopConnections {
+        EventLoop *loop;
+        std::unordered_map<uint64_t, TcpConnectionPtr> connections;
+        std::atomic_size_t size{0};
+    };
+
+    enum State {
+        Handshake,
+        Open,
+        Closing,//已发出Close，等待对端的Close
+        Closed,
+    };
+
+    struct Session;
+
+    void onConnection(const TcpConnectionPtr &conn);
+
+    void onMessage(const TcpConnectionPtr &conn, Buffer *buf);
+
+    bool handshake(const TcpConnectionPtr &conn, Session *session, Buffer *buf);
+
+    void onFrames(const TcpConnectionPtr &conn, Session *session, Buffer *buf);
+
+    LoopConnections *loopConnections(EventLoop *loop);
+
+    TcpServer server_;
+    AcceptCallback accept_callback_;
+    OpenCallback open_callback_;
+    MessageCallback message_callback_;
+    CloseCallback close_callback_;
+    size_t max_message_size_;
+    mutable std::mutex mutex_;
+    std::unordered_map<EventLoop *, std::shared_ptr<LoopConnections>> loops_;
+};
+
+#endif//MYMUDUO_WEBSOCKETSERVER_H
@@ -1,19 +1,38 @@
 #include "net/Acceptor.h"
+#include "base/FlightRecorder.h"
 #include "net/SocketOps.h"
+#include <fcntl.h>
+
+namespace {
+    int openIdleFd() {
+        return ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+}// namespace
 
 Acceptor::Acceptor(EventLoop *loop, const InetAddress &listen_addr, bool reuse_port)
     : loop_(loop), listening_(false),
       accept_socket_(SocketOps::createNonblockingSocket(listen_addr.family())),
-      accept_channel_(loop, accept_socket_.getFd()) {
+      accept_channel_(loop, accept_socket_.getFd()),
+      accept_budget_(DefaultAcceptBudget), idle_fd_(openIdleFd()) {
     accept_socket_.setReuseAddr(true);
     accept_socket_.setReusePort(reuse_port);
     accept_socket_.bind(listen_addr);
     accept_channel_.setReadCallback([this](Timestamp _) { handleRead(); });
 }
 
+Acceptor::Acceptor(EventLoop *loop, int listen_fd, bool exclusive)
+    : loop_(loop), accept_socket_(listen_fd), accept_channel_(loop, listen_fd),
+      listening_(false), accept_budget_(DefaultAcceptBudget), idle_fd_(openIdleFd()) {
+    accept_channel_.setExclusive(exclusive);
+    accept_channel_.setReadCallback([this](Timestamp _) { handleRead(); });
+}
+
 Acceptor::~Acceptor() {
     accept_channel_.disableAll();
     accept_channel_.remove();
+    if (idle_fd_ >= 0) {
+        ::close(idle_fd_);
+    }
 }
 
 void Acceptor::listen() {
@@ -23,18 +42,51 @@ void Acceptor::listen() {
 }
 
 void Acceptor::handleRead() {
-    InetAddress peer_addr{};
-    int connfd = accept_socket_.accept(&peer_addr);
-    if (connfd >= 0) {
-        if (new_connection_callback_) {
-            new_connection_callback_(connfd, peer_addr);
-        } else {
-            ::close(connfd);
+    for (int i = 0; i < accept_budget_; ++i) {
+        InetAddress peer_addr{};
+        int connfd = accept_socket_.accept(&peer_addr);
+        if (connfd >= 0) {
+            FLIGHT_RECORD(Accept, connfd, accept_socket_.getFd());
+            if (new_connections_callback_) {
+                batch_.push_back({connfd, peer_addr});
+            } else if (new_connection_callback_) {
+                new_connection_callback_(connfd, peer_addr);
+            } else {
+                ::close(connfd);
+            }
+            continue;
         }
-    } else {
-        LOG_ERROR << "accept error:" << strerror(errno);
-        if (errno == EMFILE) {
-            LOG_ERROR << "sockfd reached limit:" << strerror(errno);
+        int saved_errno = errno;
+        if (saved_errno == EAGAIN) {//已取完
+            break;
+        } else if (saved_errno == EINTR || saved_errno == ECONNABORTED || saved_errno == EPROTO) {
+            continue;
+        } else if (saved_errno == EMFILE || saved_errno == ENFILE) {
+            LOG_ERROR << "sockfd reached limit:" << strerror(saved_errno);
+            if (!rejectWithIdleFd()) {
+                break;
+            }
+        } else {
+            LOG_ERROR << "accept error:" << strerror(saved_errno);
+            break;
         }
     }
+    if (!batch_.empty()) {
+        new_connections_callback_(batch_);
+        batch_.clear();
+    }
+}
+
+bool Acceptor::rejectWithIdleFd() {
+    if (idle_fd_ < 0) {
+        idle_fd_ = openIdleFd();
+        return false;
+    }
+    ::close(idle_fd_);
+    idle_fd_ = ::accept(accept_socket_.getFd(), nullptr, nullptr);
+    if (idle_fd_ >= 0) {
+        ::close(idle_fd_);
+    }
+    idle_fd_ = openIdleFd();
+    return true;
 }
@@ -0,0 +1,106 @@
+#include "net/ComputeThreadPool.h"
+#include "base/Logging.h"
+#include <utility>
+
+ComputeThreadPool::ComputeThreadPool(int num_threads, std::string name)
+    : name_(std::move(name)), num_threads_(num_threads > 0 ? num_threads : 1),
+      running_(false), next_(0), pending_(0), idle_(0) {
+    for (int i = 0; i < num_threads_; ++i) {
+        workers_.emplace_back(std::make_unique<Worker>());
+    }
+}
+
+ComputeThreadPool::~ComputeThreadPool() {
+    if (running_) {
+        stop();
+    }
+}
+
+void ComputeThreadPool::start() {
+    running_ = true;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread([this, i] { workerFunc(i); });
+    }
+}
+
+void ComputeThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        running_ = false;
+    }
+    idle_cond_.notify_all();
+    for (auto &worker: workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void ComputeThreadPool::submit(Task task) {
+    //worker中提交的任务放入自己的队列，否则轮流放入各worker
+    size_t index = t_pool_ == this ? t_index_ : next_++ % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    ++pending_;
+    if (idle_ > 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_cond_.notify_one();
+    }
+}
+
+void ComputeThreadPool::workerFunc(size_t index) {
+    t_pool_ = this;
+    t_index_ = index;
+    Task task;
+    while (true) {
+        if (popLocal(index, &task) || steal(index, &task)) {
+            --pending_;
+            try {
+                task();
+            } catch (const std::exception &e) {
+                LOG_ERROR << "ComputeThreadPool " << name_ << " task exception:" << e.what();
+            } catch (...) {
+                LOG_ERROR << "ComputeThreadPool " << name_ << " task exception: unknown";
+            }
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        ++idle_;
+        idle_cond_.wait(lock, [this] { return pending_ > 0 || !running_; });
+        --idle_;
+        if (!running_ && pending_ <= 0) {
+            break;
+        }
+    }
+}
+
+bool ComputeThreadPool::popLocal(size_t index, Task *task) {
+    Worker &worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ComputeThreadPool::steal(size_t index, Task *task) {
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        Worker &victim = *workers_[(index + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ComputeThreadPool::logJobException(const std::string &what) const {
+    LOG_ERROR << "ComputeThreadPool " << name_ << " job exception:" << what;
+}
@@ -0,0 +1,83 @@
+#include "net/ConnectionPool.h"
+
+ConnectionPool::ConnectionPool(size_t max_free, size_t max_spare_bytes)
+    : max_free_(max_free), max_spare_bytes_(max_spare_bytes), spare_bytes_(0), block_size_(0),
+      free_list_(nullptr), free_count_(0),
+      remote_list_(nullptr) {}
+
+ConnectionPool::~ConnectionPool() {
+    freeList(free_list_);
+    freeList(remote_list_);
+}
+
+void ConnectionPool::freeList(FreeBlock *list) {
+    while (list) {
+        FreeBlock *next = list->next;
+        ::operator delete(list);
+        list = next;
+    }
+}
+
+void *ConnectionPool::allocate(size_t size) {
+    if (block_size_ == 0) {//第一次分配确定块大小和属主线程
+        block_size_ = size;
+        owner_ = std::this_thread::get_id();
+    }
+    if (size != block_size_ || !isOwnerThread()) {
+        return ::operator new(size);
+    }
+    if (free_list_ == nullptr) {
+        std::lock_guard<std::mutex> lock(remote_mutex_);
+        free_list_ = remote_list_;
+        remote_list_ = nullptr;
+        for (FreeBlock *b = free_list_; b; b = b->next) {
+            ++free_count_;
+        }
+    }
+    if (free_list_ == nullptr) {
+        return ::operator new(size);
+    }
+    FreeBlock *block = free_list_;
+    free_list_ = block->next;
+    --free_count_;
+    return block;
+}
+
+void ConnectionPool::deallocate(void *p, size_t size) {
+    if (size != block_size_) {
+        ::operator delete(p);
+        return;
+    }
+    auto *block = static_cast<FreeBlock *>(p);
+    if (isOwnerThread()) {
+        if (free_count_ >= max_free_) {
+            ::operator delete(p);
+            return;
+        }
+        block->next = free_list_;
+        free_list_ = block;
+        ++free_count_;
+    } else {
+        std::lock_guard<std::mutex> lock(remote_mutex_);
+        block->next = remote_list_;
+        remote_list_ = block;
+    }
+}
+
+std::vector<char> ConnectionPool::takeBufferStorage() {
+    if (spare_buffers_.empty()) {
+        return {};
+    }
+    std::vector<char> storage = std::move(spare_buffers_.back());
+    spare_buffers_.pop_back();
+    spare_bytes_ -= storage.capacity();
+    return storage;
+}
+
+void ConnectionPool::recycleBufferStorage(std::vector<char> storage) {
+    size_t capacity = storage.capacity();
+    if (capacity <= MaxRecycledBufferSize && spare_bytes_ + capacity <= max_spare_bytes_) {
+        spare_bytes_ += capacity;
+        spare_buffers_.push_back(std::move(storage));
+    }
+}
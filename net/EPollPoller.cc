@@ -1,13 +1,19 @@
 #include "net/EPollPoller.h"
+#include "base/BinaryLogging.h"
 #include "net/Channel.h"
 #include <cstring>
 #include <sys/epoll.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+#ifndef SYS_epoll_pwait2
+#define SYS_epoll_pwait2 441
+#endif
+
 
 EPollPoller::EPollPoller(EventLoop *loop) : Poller(loop),
                                             epoll_fd_(epoll_create1(EPOLL_CLOEXEC)),
-                                            events_(InitEventListSize) {
+                                            events_(InitEventListSize), pwait2_supported_(true) {
     if (epoll_fd_ < 0) {
         LOG_FATAL << "EPollPoller::EpollPoller error";
     }
@@ -20,7 +26,7 @@ EPollPoller::~EPollPoller() noexcept {
 void EPollPoller::removeChannel(Channel *channel) {
     int fd = channel->fd();
     channels_.erase(fd);//从channels中移除
-    LOG_TRACE << "remove channel fd:" << fd;
+    LOG_BIN_TRACE("remove channel fd:{}", fd);
     if (channel->index() == 1) {//如果它是没被移除的，则停止监听该channel
         this->update(EPOLL_CTL_DEL, channel);
     }
@@ -29,7 +35,7 @@ void EPollPoller::removeChannel(Channel *channel) {
 
 void EPollPoller::updateChannel(Channel *channel) {
     const int index = channel->index();
-    LOG_TRACE << "update channel fd:" << channel->fd();
+    LOG_BIN_TRACE("update channel fd:{}", channel->fd());
     if (index == -1 || index == 2) {//如果它是被移除或被暂停监听的
         if (index == -1) {//如果是被移除的
             int fd = channel->fd();
@@ -50,10 +56,29 @@ void EPollPoller::updateChannel(Channel *channel) {
 
 Timestamp EPollPoller::poll(int timeout_ms, Poller::ChannelList *active_channels) {
     int num_events = epoll_wait(epoll_fd_, events_.data(), static_cast<int>(events_.size()), timeout_ms);
-    int save_errno = errno;
+    return afterPoll(num_events, errno, active_channels);
+}
+
+Timestamp EPollPoller::pollNs(int64_t timeout_ns, Poller::ChannelList *active_channels) {
+    if (pwait2_supported_) {
+        timespec ts{};
+        ts.tv_sec = static_cast<time_t>(timeout_ns / Timestamp::NanoSecondsPerSecond);
+        ts.tv_nsec = static_cast<long>(timeout_ns % Timestamp::NanoSecondsPerSecond);
+        auto num_events = static_cast<int>(::syscall(SYS_epoll_pwait2, epoll_fd_, events_.data(), static_cast<int>(events_.size()),
+                                                     timeout_ns < 0 ? nullptr : &ts, nullptr, 0));
+        if (num_events >= 0 || errno != ENOSYS) {
+            return afterPoll(num_events, errno, active_channels);
+        }
+        LOG_INFO << "epoll_pwait2 not supported, fall back to epoll_wait";
+        pwait2_supported_ = false;
+    }
+    return Poller::pollNs(timeout_ns, active_channels);
+}
+
+Timestamp EPollPoller::afterPoll(int num_events, int save_errno, Poller::ChannelList *active_channels) {
     Timestamp now(Timestamp::now());
     if (num_events > 0) {//如果有事件发送
-        LOG_TRACE << num_events << " events happened";
+        LOG_BIN_TRACE("{} events happened", num_events);
         fillActivateChannels(num_events, active_channels);//将发送事件的channel添加到active_channels，以供EventLoop使用
         if (num_events == events_.size()) {//如果所有事件都发送了，扩大epoll_wait返回的数量
             events_.resize(events_.size() * 2);
@@ -61,10 +86,10 @@ Timestamp EPollPoller::poll(int timeout_ms, Poller::ChannelList *active_channels
     } else if (num_events == 0) {
 
     } else {
-        if (save_errno != EINTR) {
+        if (save_errno != EINTR) {//被信号（如FlightRecorder的dump信号）打断不算错误
             errno = save_errno;
+            LOG_ERROR << "EPollPoller::poll() error:" << strerror(errno);
         }
-        LOG_ERROR << "EPollPoller::poll() error:" << strerror(errno);
     }
     return now;
 }
@@ -82,6 +107,9 @@ void EPollPoller::update(int operation, Channel *channel) {
     int fd = channel->fd();
     //memset(&event, 0, sizeof(event));
     event.events = channel->events();
+    if (operation == EPOLL_CTL_ADD && channel->exclusive()) {//EPOLLEXCLUSIVE只能在ADD时使用
+        event.events |= EPOLLEXCLUSIVE;
+    }
     event.data.fd = fd;
     event.data.ptr = channel;
     if (::epoll_ctl(epoll_fd_, operation, fd, &event) < 0) {
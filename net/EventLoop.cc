@@ -1,9 +1,13 @@
 #include "net/EventLoop.h"
+#include "base/CurrentThread.h"
+#include "base/FlightRecorder.h"
 #include "net/Channel.h"
 #include "net/EPollPoller.h"
 #include "net/Poller.h"
 #include "net/TimerId.h"
 #include "net/TimerQueue.h"
+#include <algorithm>
+#include <csignal>
 #include <cstring>
 #include <sys/eventfd.h>
 #include <unistd.h>
@@ -12,20 +16,32 @@ thread_local EventLoop *t_loopInThisThread = nullptr;
 
 const int PollTimeMs = 10000;
 
+namespace {
+    //对端已关闭时write返回EPIPE，而不是让SIGPIPE终止进程
+    struct IgnoreSigPipe {
+        IgnoreSigPipe() {
+            ::signal(SIGPIPE, SIG_IGN);
+        }
+    } ignore_sig_pipe;
+}// namespace
+
 EventLoop::EventLoop() : looping_(false), quit_(false),
-                         calling_pending_functions_(false),
+                         thread_id_(std::this_thread::get_id()),
                          poller_(new EPollPoller(this)),
-                         timer_queue_(new TimerQueue(this)),
-                         thread_id_(std::this_thread::get_id()) {
+                         timer_queue_(TimerQueue::newTimerQueue(this, TimerQueue::Ordered)),
+                         timer_queue_type_(TimerQueue::Ordered), poll_timers_(false),
+                         busy_nanos_(0), busy_since_(0),
+                         calling_pending_functions_(false) {
+    FlightRecorder::attachThread("EventLoop");//EventLoopThread已用线程名分配过时不再分配
     int evtfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     if (evtfd < 0) {
         LOG_FATAL << "eventfd error:" << strerror(errno);
     }
     this->wakeup_fd_ = evtfd;
     this->wakeup_channel_ = std::make_unique<Channel>(this, wakeup_fd_);
-    LOG_DEBUG << "EventLoop created " << this << " in base" << thread_id_;
+    LOG_DEBUG << "EventLoop created " << this << " in thread " << CurrentThread::tid();
     if (t_loopInThisThread) {
-        LOG_FATAL << "Another EventLoop " << t_loopInThisThread << " exists in this base " << thread_id_;
+        LOG_FATAL << "Another EventLoop " << t_loopInThisThread << " exists in this thread " << CurrentThread::tid();
     } else {
         t_loopInThisThread = this;
     }
@@ -47,16 +63,39 @@ void EventLoop::loop() {
     LOG_TRACE << "EventLoop " << this << " start looping";
     while (!quit_) {
         active_channels_.clear();
-        poll_return_time_ = poller_->poll(PollTimeMs, &active_channels_);
+        Timestamp next_timer;
+        if (poll_timers_) {//poll超时设为最近的定时器
+            next_timer = timer_queue_->nextWakeup();
+            int64_t timeout_ns = static_cast<int64_t>(PollTimeMs) * 1000 * 1000;
+            if (next_timer.valid()) {
+                timeout_ns = std::min(timeout_ns, std::max<int64_t>(0, next_timer.nanoSeconds() - Timestamp::now().nanoSeconds()));
+            }
+            poll_return_time_ = poller_->pollNs(timeout_ns, &active_channels_);
+        } else {
+            poll_return_time_ = poller_->poll(PollTimeMs, &active_channels_);
+        }
+        FLIGHT_RECORD(PollReturn, -1, static_cast<int64_t>(active_channels_.size()));
+        int64_t busy_start = poll_return_time_.nanoSeconds();
+        busy_since_.store(busy_start, std::memory_order_relaxed);
         for (Channel *channel: active_channels_) {
             channel->handleEvent((poll_return_time_));
         }
+        if (next_timer.valid() && !(poll_return_time_ < next_timer)) {
+            timer_queue_->processExpired(poll_return_time_);
+        }
         this->doPendingFunctors();
+        busy_nanos_.fetch_add(Timestamp::now().nanoSeconds() - busy_start, std::memory_order_relaxed);
+        busy_since_.store(0, std::memory_order_relaxed);
     }
     LOG_TRACE << "EventLoop " << this << " stop looping";
     looping_ = false;
 }
 
+int64_t EventLoop::busyNanos() const {
+    int64_t since = busy_since_.load(std::memory_order_relaxed);//正在处理中的时间也算上
+    return busy_nanos_.load(std::memory_order_relaxed) + (since > 0 ? Timestamp::now().nanoSeconds() - since : 0);
+}
+
 void EventLoop::quit() {
     quit_ = true;
     if (!this->isInLoopThread()) {
@@ -64,20 +103,52 @@ void EventLoop::quit() {
     }
 }
 
-TimerId EventLoop::runAt(const Timestamp &time, const TimerCallback &cb) {
-    return timer_queue_->addTimer(cb, time, 0.0);
+TimerId EventLoop::runAt(const Timestamp &time, const TimerCallback &cb, double slack) {
+    return timer_queue_->addTimer(cb, time, 0.0, slack);
 }
 
-TimerId EventLoop::runAfter(double delay, const TimerCallback &cb) {
+TimerId EventLoop::runAfter(double delay, const TimerCallback &cb, double slack) {
     Timestamp time(Timestamp::now() + delay);
-    return runAt(time, cb);
+    return runAt(time, cb, slack);
 }
 
-TimerId EventLoop::runEvery(double interval, const TimerCallback &cb) {
+TimerId EventLoop::runEvery(double interval, const TimerCallback &cb, double slack) {
     Timestamp time(Timestamp::now() + interval);
-    return timer_queue_->addTimer(cb, time, interval);
+    return timer_queue_->addTimer(cb, time, interval, slack);
+}
+
+void EventLoop::setTimerSlack(double slack) {
+    timer_queue_->setDefaultSlack(slack);
+}
+
+void EventLoop::cancel(TimerId timer_id) {
+    timer_queue_->cancel(timer_id);
 }
 
+void EventLoop::setTimerQueueType(TimerQueue::Type type) {
+    if (!isInLoopThread() || timer_queue_->size() > 0) {
+        LOG_ERROR << "EventLoop::setTimerQueueType must be called in loop thread before adding timers";
+        return;
+    }
+    resetTimerQueue(type, poll_timers_);
+}
+
+void EventLoop::setPollTimers(bool on) {
+    if (!isInLoopThread() || timer_queue_->size() > 0) {
+        LOG_ERROR << "EventLoop::setPollTimers must be called in loop thread before adding timers";
+        return;
+    }
+    resetTimerQueue(timer_queue_type_, on);
+}
+
+void EventLoop::resetTimerQueue(TimerQueue::Type type, bool poll_timers) {
+    double slack = timer_queue_->defaultSlack();
+    timer_queue_.reset();//先移除旧的timerfd
+    timer_queue_.reset(TimerQueue::newTimerQueue(this, type, !poll_timers));
+    timer_queue_->setDefaultSlack(slack);
+    timer_queue_type_ = type;
+    poll_timers_ = poll_timers;
+}
 
 void EventLoop::runInLoop(Functor cb) {
     if (this->isInLoopThread()) {
@@ -136,6 +207,9 @@ void EventLoop::doPendingFunctors() {
         std::lock_guard<std::mutex> lock(mutex_);
         functors.swap(pending_functors_);
     }
+    if (!functors.empty()) {
+        FLIGHT_RECORD(Functors, -1, static_cast<int64_t>(functors.size()));
+    }
     for (const Functor &functor: functors) {
         functor();
     }
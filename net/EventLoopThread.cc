@@ -1,13 +1,15 @@
 #include "net/EventLoopThread.h"
 
 #include <utility>
+#include "base/FlightRecorder.h"
+#include "base/Logging.h"
 #include "net/EventLoop.h"
 
-EventLoopThread::EventLoopThread(ThreadInitCallback cb, std::string name)
+EventLoopThread::EventLoopThread(ThreadInitCallback cb, std::string name, CpuAffinity::CpuSet cpus)
     : loop_(nullptr), exiting_(false),
       name_(std::move(name)),
-      thread_([this] { threadFunc(); }),
-      mutex_(), cond_(), callback_(std::move(cb)) {}
+      mutex_(), cond_(), callback_(std::move(cb)),
+      cpus_(std::move(cpus)) {}
 
 EventLoopThread::~EventLoopThread() {
     exiting_ = true;
@@ -18,6 +20,7 @@ EventLoopThread::~EventLoopThread() {
 }
 
 EventLoop *EventLoopThread::startLoop() {
+    thread_ = std::thread([this] { threadFunc(); });//成员都初始化完成后再启动线程
     EventLoop *loop = nullptr;
     {
         std::unique_lock<std::mutex> lock(mutex_);
@@ -30,6 +33,16 @@ EventLoop *EventLoopThread::startLoop() {
 }
 
 void EventLoopThread::threadFunc() {
+    if (!cpus_.empty()) {//先绑核再创建EventLoop，使loop及其连接的内存落在本NUMA节点
+        if (CpuAffinity::bindThisThread(cpus_)) {
+            int node = CpuAffinity::currentNode();
+            CpuAffinity::preferNode(node);
+            LOG_DEBUG << "EventLoopThread " << name_ << " bound to cpu " << CpuAffinity::currentCpu() << " node " << node;
+        } else {
+            LOG_ERROR << "EventLoopThread " << name_ << " set affinity error";
+        }
+    }
+    FlightRecorder::attachThread(name_.c_str());
     EventLoop loop;
     if (callback_) {
         callback_(&loop);
@@ -42,4 +55,4 @@ void EventLoopThread::threadFunc() {
     loop.loop();
     std::unique_lock<std::mutex> lock(mutex_);
     loop_ = nullptr;
-}
\ No newline at end of file
+}
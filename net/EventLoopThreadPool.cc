@@ -2,11 +2,15 @@
 
 #include "net/EventLoop.h"
 #include "net/EventLoopThread.h"
+#include "net/InetAddress.h"
 #include <utility>
 
+const int64_t LoadWindowNanos = 100 * 1000 * 1000;
+
 EventLoopThreadPool::EventLoopThreadPool(EventLoop *base_loop, std::string name)
     : base_loop_(base_loop), started_(false),
-      name_(std::move(name)), num_threads_(0), next_(0) {
+      name_(std::move(name)), num_threads_(0), next_(0),
+      policy_(RoundRobin), load_window_start_(0) {
 }
 
 EventLoopThreadPool::~EventLoopThreadPool() = default;
@@ -19,29 +23,118 @@ void EventLoopThreadPool::start(const EventLoopThreadPool::ThreadInitCallback &c
         for (int i = 0; i < num_threads_; ++i) {
             char buf[this->name_.size() + 32];
             snprintf(buf, sizeof(buf), "%s %d", name_.c_str(), i);
-            auto t = std::make_unique<EventLoopThread>(cb, std::move(std::string(buf)));
+            CpuAffinity::CpuSet cpus = cpu_sets_.empty() ? CpuAffinity::CpuSet() : cpu_sets_[i % cpu_sets_.size()];
+            auto t = std::make_unique<EventLoopThread>(cb, std::move(std::string(buf)), std::move(cpus));
             auto loop = t->startLoop();
             threads_.emplace_back(std::move(t));
             loops_.emplace_back(loop);
         }
     }
+    dispatch_loops_ = getAllLoops();
+    for (EventLoop *loop: dispatch_loops_) {
+        stats_.emplace_back(std::make_unique<LoopStats>());
+        stats_index_[loop] = stats_.back().get();
+    }
 }
 
 EventLoop *EventLoopThreadPool::getNextLoop() {
     EventLoop *loop = base_loop_;
     if (!loops_.empty()) {
-        loop = loops_[next_++];
-        if (next_ >= loops_.size()) {
-            next_ = 0;
-        }
+        loop = loops_[next_++ % loops_.size()];//pickIndex也推进next_，不能假设它小于size
     }
     return loop;
 }
 
+EventLoop *EventLoopThreadPool::getLoopForConnection(const InetAddress &peer_addr) {
+    if (dispatch_loops_.empty()) {
+        return base_loop_;
+    }
+    size_t index = pickIndex(peer_addr) % dispatch_loops_.size();
+    stats_[index]->connections.fetch_add(1, std::memory_order_relaxed);
+    return dispatch_loops_[index];
+}
+
+size_t EventLoopThreadPool::pickIndex(const InetAddress &peer_addr) {
+    size_t n = dispatch_loops_.size();
+    if (dispatch_callback_) {
+        return dispatch_callback_(dispatch_loops_, peer_addr);
+    }
+    switch (policy_) {
+        case LeastConnections: {
+            size_t start = next_++ % n;//从轮转位置开始找，连接数相同时分散开
+            size_t best = start;
+            for (size_t i = 1; i < n; ++i) {
+                size_t index = (start + i) % n;
+                if (stats_[index]->connections.load(std::memory_order_relaxed) <
+                    stats_[best]->connections.load(std::memory_order_relaxed)) {
+                    best = index;
+                }
+            }
+            return best;
+        }
+        case LeastLoad: {
+            refreshLoad();
+            size_t start = next_++ % n;
+            size_t best = start;
+            for (size_t i = 1; i < n; ++i) {
+                size_t index = (start + i) % n;
+                if (stats_[index]->recent_busy < stats_[best]->recent_busy) {
+                    best = index;
+                }
+            }
+            return best;
+        }
+        case HashPeer: {
+            auto addr = reinterpret_cast<const sockaddr_in *>(peer_addr.getSockAddr());
+            uint64_t h = static_cast<uint64_t>(addr->sin_addr.s_addr) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(h >> 32) % n;
+        }
+        case RoundRobin:
+        default:
+            return next_++ % n;
+    }
+}
+
+void EventLoopThreadPool::refreshLoad() {
+    //recent_busy为快照以来的忙碌时间，每过一个窗口快照推进一半，近似指数衰减
+    int64_t now = Timestamp::now().nanoSeconds();
+    bool roll = now - load_window_start_ >= LoadWindowNanos;
+    for (size_t i = 0; i < dispatch_loops_.size(); ++i) {
+        LoopStats &stats = *stats_[i];
+        int64_t busy = dispatch_loops_[i]->busyNanos();
+        stats.recent_busy = busy - stats.busy_snapshot;
+        if (roll) {
+            stats.busy_snapshot = busy - stats.recent_busy / 2;
+        }
+    }
+    if (roll) {
+        load_window_start_ = now;
+    }
+}
+
+void EventLoopThreadPool::acquireConnection(EventLoop *loop) {
+    auto it = stats_index_.find(loop);
+    if (it != stats_index_.end()) {
+        it->second->connections.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EventLoopThreadPool::releaseConnection(EventLoop *loop) {
+    auto it = stats_index_.find(loop);
+    if (it != stats_index_.end()) {
+        it->second->connections.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+int EventLoopThreadPool::connectionCount(EventLoop *loop) const {
+    auto it = stats_index_.find(loop);
+    return it == stats_index_.end() ? 0 : it->second->connections.load(std::memory_order_relaxed);
+}
+
 std::vector<EventLoop *> EventLoopThreadPool::getAllLoops() {
     if (loops_.empty()) {
         return {1, base_loop_};
     } else {
         return loops_;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,56 @@
+#include "net/LengthHeaderCodec.h"
+#include "base/Logging.h"
+#include "net/TcpConnection.h"
+
+namespace {
+    //同一线程的所有连接共用，每次send后清空
+    thread_local Buffer t_output;
+}// namespace
+
+LengthHeaderCodec::LengthHeaderCodec(FrameCallback cb, size_t max_frame_size)
+    : frame_callback_(std::move(cb)), max_frame_size_(max_frame_size) {}
+
+void LengthHeaderCodec::onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time) {
+    while (buf->readableBytes() >= HeaderLen) {
+        auto len = static_cast<uint32_t>(buf->peekInt32());
+        if (len > max_frame_size_) {
+            if (error_callback_) {
+                error_callback_(conn, len);
+            } else {
+                LOG_ERROR << "LengthHeaderCodec invalid frame length " << len << " on connection " << conn->name();
+                conn->forceClose();
+            }
+            buf->retrieveAll();
+            break;
+        }
+        if (buf->readableBytes() < HeaderLen + len) {
+            break;
+        }
+        frame_callback_(conn, std::string_view(buf->peek() + HeaderLen, len), receive_time);
+        buf->retrieve(HeaderLen + len);
+    }
+}
+
+void LengthHeaderCodec::encode(Buffer *buf) {
+    auto len = static_cast<int32_t>(buf->readableBytes());
+    if (buf->prependableBytes() >= HeaderLen) {
+        buf->prependInt32(len);
+        return;
+    }
+    std::string body = buf->retrieveAllAsString();//预留区已被占用时才复制，retrieveAll后预留区恢复
+    buf->append(body);
+    buf->prependInt32(len);
+}
+
+void LengthHeaderCodec::send(const TcpConnectionPtr &conn, Buffer *buf) {
+    encode(buf);
+    conn->send(buf);
+}
+
+void LengthHeaderCodec::send(const TcpConnectionPtr &conn, std::string_view frame) {
+    Buffer &output = t_output;
+    output.appendInt32(static_cast<int32_t>(frame.size()));
+    output.append(frame.data(), frame.size());
+    conn->send(&output);
+    output.retrieveAll();//连接已不在Connected状态时帧未写出，不能留给下一个连接
+}
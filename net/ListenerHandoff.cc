@@ -0,0 +1,122 @@
+#include "net/ListenerHandoff.h"
+#include "base/Logging.h"
+#include "net/EventLoop.h"
+#include "net/SocketOps.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+    const char HandoffTag[] = "mymuduo-listeners";
+
+    bool fillUnixAddr(const std::string &path, sockaddr_un *addr) {
+        if (path.size() >= sizeof(addr->sun_path)) {
+            LOG_ERROR << "ListenerHandoff: path too long " << path;
+            return false;
+        }
+        addr->sun_family = AF_UNIX;
+        memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    int createHandoffListener(const std::string &path) {
+        sockaddr_un addr{};
+        if (!fillUnixAddr(path, &addr)) {
+            return -1;
+        }
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            LOG_FATAL << "ListenerHandoff socket:" << strerror(errno);
+        }
+        ::unlink(path.c_str());//上一个进程留下的路径
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(fd, 1) < 0) {
+            LOG_ERROR << "ListenerHandoff bind/listen " << path << ":" << strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+}// namespace
+
+ListenerHandoff::ListenerHandoff(EventLoop *loop, std::string path)
+    : loop_(loop), path_(std::move(path)), listen_fd_(createHandoffListener(path_)),
+      channel_(loop, listen_fd_) {
+    channel_.setReadCallback([this](Timestamp) { handleRead(); });
+}
+
+ListenerHandoff::~ListenerHandoff() {
+    closeListener();
+}
+
+void ListenerHandoff::start() {
+    loop_->runInLoop([this] {
+        if (listen_fd_ >= 0) {
+            channel_.enableReading();
+        }
+    });
+}
+
+void ListenerHandoff::handleRead() {
+    int conn_fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (conn_fd < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+            LOG_ERROR << "ListenerHandoff accept:" << strerror(errno);
+        }
+        return;
+    }
+    std::vector<int> fds = provider_ ? provider_() : std::vector<int>();
+    bool ok = !fds.empty() && SocketOps::sendFds(conn_fd, fds, HandoffTag);
+    ::close(conn_fd);
+    if (!ok) {//继续等待下一次交接
+        LOG_ERROR << "ListenerHandoff failed to hand off " << fds.size() << " listen fds";
+        return;
+    }
+    LOG_INFO << "ListenerHandoff handed off " << fds.size() << " listen fds via " << path_;
+    closeListener();
+    if (handoff_callback_) {
+        handoff_callback_();
+    }
+}
+
+void ListenerHandoff::closeListener() {
+    if (listen_fd_ < 0) {
+        return;
+    }
+    channel_.disableAll();
+    channel_.remove();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+std::vector<int> ListenerHandoff::takeOver(const std::string &path, double timeout) {
+    std::vector<int> fds;
+    sockaddr_un addr{};
+    if (!fillUnixAddr(path, &addr)) {
+        return fds;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR << "ListenerHandoff::takeOver socket:" << strerror(errno);
+        return fds;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {//没有旧进程
+        LOG_INFO << "ListenerHandoff::takeOver no predecessor on " << path << ":" << strerror(errno);
+        ::close(fd);
+        return fds;
+    }
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout);
+    tv.tv_usec = static_cast<suseconds_t>((timeout - static_cast<double>(tv.tv_sec)) * 1000 * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::string payload;
+    if (SocketOps::recvFds(fd, &fds, &payload) && payload != HandoffTag) {
+        LOG_ERROR << "ListenerHandoff::takeOver unexpected payload from " << path;
+        for (int passed: fds) {
+            ::close(passed);
+        }
+        fds.clear();
+    }
+    ::close(fd);
+    LOG_INFO << "ListenerHandoff::takeOver received " << fds.size() << " listen fds from " << path;
+    return fds;
+}
@@ -0,0 +1,87 @@
+#include "net/OrderedTimerQueue.h"
+#include "net/Timer.h"
+#include <algorithm>
+
+OrderedTimerQueue::OrderedTimerQueue(EventLoop *loop, bool use_timerfd) : TimerQueue(loop, use_timerfd) {}
+
+void OrderedTimerQueue::insert(Timer *timer) {
+    heap_.push_back({timer->deadline(), timer->expiration(), timer->sequence(), timer});
+    timer->index_ = static_cast<int>(heap_.size() - 1);
+    siftUp(heap_.size() - 1);
+}
+
+bool OrderedTimerQueue::erase(Timer *timer) {
+    if (timer->index_ < 0) {
+        return false;
+    }
+    removeAt(static_cast<size_t>(timer->index_));
+    return true;
+}
+
+void OrderedTimerQueue::takeExpired(Timestamp now, std::vector<Timer *> *expired) {//取出已到期的Timer
+    while (!heap_.empty() && !(now < heap_.front().when)) {
+        expired->push_back(heap_.front().timer);
+        removeAt(0);
+    }
+}
+
+Timestamp OrderedTimerQueue::earliest() const {
+    return heap_.empty() ? Timestamp() : heap_.front().deadline;
+}
+
+void OrderedTimerQueue::removeAt(size_t index) {
+    heap_[index].timer->index_ = -1;
+    Entry last = heap_.back();
+    heap_.pop_back();
+    if (index == heap_.size()) {//删除的就是最后一个
+        return;
+    }
+    moveTo(last, index);
+    if (index > 0 && before(last, heap_[(index - 1) / Arity])) {
+        siftUp(index);
+    } else {
+        siftDown(index);
+    }
+}
+
+void OrderedTimerQueue::siftUp(size_t index) {
+    Entry entry = heap_[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / Arity;
+        if (!before(entry, heap_[parent])) {
+            break;
+        }
+        moveTo(heap_[parent], index);
+        index = parent;
+    }
+    moveTo(entry, index);
+}
+
+void OrderedTimerQueue::siftDown(size_t index) {
+    Entry entry = heap_[index];
+    size_t size = heap_.size();
+    while (true) {
+        size_t first = index * Arity + 1;
+        if (first >= size) {
+            break;
+        }
+        size_t last = std::min(first + Arity, size);
+        size_t min_child = first;
+        for (size_t child = first + 1; child < last; ++child) {
+            if (before(heap_[child], heap_[min_child])) {
+                min_child = child;
+            }
+        }
+        if (!before(heap_[min_child], entry)) {
+            break;
+        }
+        moveTo(heap_[min_child], index);
+        index = min_child;
+    }
+    moveTo(entry, index);
+}
+
+void OrderedTimerQueue::moveTo(Entry entry, size_t index) {
+    heap_[index] = entry;
+    entry.timer->index_ = static_cast<int>(index);
+}
@@ -3,6 +3,12 @@
 
 Poller::Poller(EventLoop *loop) : owner_loop_(loop) {}
 
+Timestamp Poller::pollNs(int64_t timeout_ns, ChannelList *active_channels) {
+    const int64_t NanoSecondsPerMs = 1000 * 1000;
+    int timeout_ms = timeout_ns < 0 ? -1 : static_cast<int>((timeout_ns + NanoSecondsPerMs - 1) / NanoSecondsPerMs);
+    return poll(timeout_ms, active_channels);
+}
+
 bool Poller::hasChannel(Channel *channel) const {
     auto it = channels_.find(channel->fd());
     return it != channels_.end() && it->second == channel;
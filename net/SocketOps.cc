@@ -1,6 +1,7 @@
 #include "net/SocketOps.h"
 #include "base/Logging.h"
 #include <cstring>
+#include <sys/socket.h>
 
 
 namespace SocketOps {
@@ -12,6 +13,14 @@ namespace SocketOps {
         return fd;
     }
 
+    int createNonblockingUdpSocket(sa_family_t family) {
+        int fd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+        if (fd < 0) {
+            LOG_FATAL << "Sockets::createNonblockingUdpSocket:" << strerror(errno);
+        }
+        return fd;
+    }
+
     int connect(int fd, const sockaddr *addr) {
         return ::connect(fd, addr, sizeof(sockaddr_in));
     }
@@ -32,16 +41,30 @@ namespace SocketOps {
         auto addrlen = static_cast<socklen_t>(sizeof(*addr));
         int coonfd = ::accept4(fd, reinterpret_cast<sockaddr *>(addr), &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (coonfd < 0) {
-            LOG_FATAL << "Socket::accept";
             int no = errno;
-            switch (no) {
+            switch (no) {//可恢复的错误交给调用者处理
+                case EAGAIN:
+                case ECONNABORTED:
+                case EINTR:
+                case EPROTO:
+                case EPERM:
                 case EMFILE:
-                    errno = no;
+                case ENFILE:
+                case ENOBUFS:
+                case ENOMEM:
                     break;
+                case EBADF:
+                case EFAULT:
+                case EINVAL:
+                case ENOTSOCK:
                 case EOPNOTSUPP:
                     LOG_FATAL << "unexpected error of ::accept:" << strerror(no);
                     break;
+                default:
+                    LOG_FATAL << "unknown error of ::accept:" << strerror(no);
+                    break;
             }
+            errno = no;
         }
         return coonfd;
     }
@@ -107,4 +130,68 @@ namespace SocketOps {
             return false;
         }
     }
-}// namespace SocketOps
\ No newline at end of file
+
+    const size_t MaxPassedFds = 253;//SCM_MAX_FD
+    const size_t MaxPayload = 4096;
+
+    bool sendFds(int unix_fd, const std::vector<int> &fds, const std::string &payload) {
+        if (fds.empty() || fds.size() > MaxPassedFds || payload.size() > MaxPayload) {
+            LOG_ERROR << "SocketOps::sendFds: bad fd count " << fds.size() << " or payload size " << payload.size();
+            return false;
+        }
+        std::string data = payload.empty() ? std::string(1, '\0') : payload;//至少要有1字节数据才能携带控制信息
+        iovec iov{const_cast<char *>(data.data()), data.size()};
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+        ssize_t n;
+        do {
+            n = ::sendmsg(unix_fd, &msg, MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) {
+            LOG_ERROR << "SocketOps::sendFds:" << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool recvFds(int unix_fd, std::vector<int> *fds, std::string *payload) {
+        std::vector<char> data(MaxPayload);
+        iovec iov{data.data(), data.size()};
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * MaxPassedFds));
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        ssize_t n;
+        do {
+            n = ::recvmsg(unix_fd, &msg, MSG_CMSG_CLOEXEC);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            LOG_ERROR << "SocketOps::recvFds:" << (n == 0 ? "peer closed" : strerror(errno));
+            return false;
+        }
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                size_t old_size = fds->size();
+                fds->resize(old_size + count);
+                memcpy(fds->data() + old_size, CMSG_DATA(cmsg), sizeof(int) * count);
+            }
+        }
+        if (msg.msg_flags & MSG_CTRUNC) {
+            LOG_ERROR << "SocketOps::recvFds: control message truncated";
+        }
+        payload->assign(data.data(), n);
+        return true;
+    }
+}// namespace SocketOps
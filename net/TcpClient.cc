@@ -78,6 +78,12 @@ void TcpClient::newConnection(int sockfd) {
     conn->setMessageCallback(message_callback_);
     conn->setWriteCompleteCallback(write_complete_callback_);
     conn->setCloseCallback([this](const TcpConnectionPtr &conn) { removeConnection(conn); });
+#ifdef MYMUDUO_HAS_TLS
+    if (tls_context_ != nullptr) {
+        conn->startTls(tls_context_, tls_server_name_,
+                       tls_server_name_.empty() ? connector_->serverAddress().toIpPort() : tls_server_name_);
+    }
+#endif
     {
         std::lock_guard<std::mutex> lk(mutex_);
         connection_ = conn;
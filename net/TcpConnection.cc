@@ -1,11 +1,13 @@
 #include "net/TcpConnection.h"
-#include "net/Channel.h"
+#include "base/BinaryLogging.h"
+#include "base/FlightRecorder.h"
+#include "net/ConnectionPool.h"
 #include "net/EventLoop.h"
-#include "net/Socket.h"
+#include "net/TlsFilter.h"
 #include <utility>
 
 void defaultConnectionCallback(const TcpConnectionPtr &conn) {
-    LOG_TRACE << "new connect";
+    LOG_BIN_TRACE("connection {} is {}", conn->id(), conn->connect() ? "UP" : "DOWN");
 }
 
 void defaultMessageCallback(const TcpConnectionPtr &conn, Buffer *buf, Timestamp time) {
@@ -15,42 +17,91 @@ void defaultMessageCallback(const TcpConnectionPtr &conn, Buffer *buf, Timestamp
 TcpConnection::TcpConnection(EventLoop *loop, std::string name,
                              int sockfd, const InetAddress &local_addr,
                              const InetAddress &peer_addr)
-    : loop_(loop), name_(std::move(name)), state_(Connecting),
-      reading_(true), socket_(new Socket(sockfd)),
-      channel_(new Channel(loop, sockfd)),
+    : TcpConnection(loop, 0, nullptr, sockfd, local_addr, peer_addr) {
+    name_ = std::move(name);
+}
+
+TcpConnection::TcpConnection(EventLoop *loop, uint64_t id, std::shared_ptr<const std::string> name_prefix,
+                             int sockfd, const InetAddress &local_addr,
+                             const InetAddress &peer_addr,
+                             ConnectionPool *pool)
+    : loop_(loop), id_(id), name_prefix_(std::move(name_prefix)), state_(Connecting),
+      reading_(true), pool_(pool), socket_(sockfd),
+      channel_(loop, sockfd),
       local_addr_(local_addr), peer_addr_(peer_addr),
-      high_water_mark_(64 * 1024 * 1024) {
-    channel_->setReadCallback([this](auto &&t) { handleRead(std::forward<decltype(t)>(t)); });
-    channel_->setWriteCallback([this] { handleWrite(); });
-    channel_->setErrorCallback([this] { handleError(); });
-    channel_->setCloseCallback([this] { handleClose(); });
-    socket_->setKeepAlive(true);
+      high_water_mark_(64 * 1024 * 1024),
+      input_buffer_(pool ? pool->takeBufferStorage() : std::vector<char>()),
+      output_buffer_(pool ? pool->takeBufferStorage() : std::vector<char>()) {
+    channel_.setReadCallback([this](auto &&t) { handleRead(std::forward<decltype(t)>(t)); });
+    channel_.setWriteCallback([this] { handleWrite(); });
+    channel_.setErrorCallback([this] { handleError(); });
+    channel_.setCloseCallback([this] { handleClose(); });
+    socket_.setKeepAlive(true);
 }
 
-TcpConnection::~TcpConnection() = default;
+TcpConnection::~TcpConnection() {
+    if (pool_ && pool_->isOwnerThread()) {
+        pool_->recycleBufferStorage(input_buffer_.releaseStorage());
+        pool_->recycleBufferStorage(output_buffer_.releaseStorage());
+    }
+}
 
 void TcpConnection::send(const std::string &buf) {
     if (state_ == Connected) {
         if (loop_->isInLoopThread()) {
-            sendInLoop(buf);
+            sendInLoop(buf.data(), buf.size());
+        } else {
+            loop_->runInLoop([this, buf] { sendInLoop(buf.data(), buf.size()); });
+        }
+    }
+}
+
+void TcpConnection::send(const void *data, size_t len) {
+    if (state_ == Connected) {
+        if (loop_->isInLoopThread()) {
+            sendInLoop(static_cast<const char *>(data), len);
         } else {
-            loop_->runInLoop([this, buf] { sendInLoop(buf); });
+            send(std::string(static_cast<const char *>(data), len));
         }
     }
 }
 
-void TcpConnection::sendInLoop(const std::string &msg) {
+void TcpConnection::send(Buffer *buf) {
+    if (state_ == Connected) {
+        if (loop_->isInLoopThread()) {
+            sendInLoop(buf->peek(), buf->readableBytes());
+        } else {
+            send(buf->retrieveAllAsString());
+        }
+    }
+    buf->retrieveAll();//未连接时也丢弃，调用方常复用同一个buf
+}
+
+void TcpConnection::sendInLoop(const char *data, size_t len) {
     ssize_t nwrote = 0;
-    size_t remaining = msg.size();
+    size_t remaining = len;
     bool fault_error = false;
 
     if (state_ == Disconnected) {
         return;
     }
-    if (!channel_->isWriting() && output_buffer_.readableBytes() == 0) {
-        nwrote = ::write(channel_->fd(), msg.c_str(), msg.size());
+    bool writable = !channel_.isWriting();
+#ifdef MYMUDUO_HAS_TLS
+    writable = writable && (!tls_ || tls_->handshakeDone());//握手完成前只放入输出Buffer
+#endif
+    if (writable && output_buffer_.readableBytes() == 0) {
+#ifdef MYMUDUO_HAS_TLS
+        int saved_errno = 0;
+        nwrote = tls_ ? tls_->write(data, len, &saved_errno) : ::write(channel_.fd(), data, len);
+        if (tls_ && nwrote < 0) {
+            errno = saved_errno;
+        }
+#else
+        nwrote = ::write(channel_.fd(), data, len);
+#endif
+        FLIGHT_RECORD(Write, channel_.fd(), nwrote);
         if (nwrote >= 0) {
-            remaining = msg.size() - nwrote;
+            remaining = len - nwrote;
             if (remaining == 0 && write_complete_callback_) {
                 loop_->queueInLoop([this] { write_complete_callback_(shared_from_this()); });
             }
@@ -70,9 +121,9 @@ void TcpConnection::sendInLoop(const std::string &msg) {
         if (old_len + remaining >= high_water_mark_ && old_len < high_water_mark_ && high_water_mark_callback_) {
             loop_->queueInLoop(std::bind(high_water_mark_callback_, shared_from_this(), old_len + remaining));
         }
-        output_buffer_.append(msg.c_str() + nwrote, remaining);
-        if (!channel_->isWriting()) {
-            channel_->enableWriting();
+        output_buffer_.append(data + nwrote, remaining);
+        if (writable) {
+            channel_.enableWriting();
         }
     }
 }
@@ -85,30 +136,50 @@ void TcpConnection::shutdown() {
 }
 
 void TcpConnection::shutdownInLoop() {
-    if (!channel_->isWriting()) {
-        socket_->shutdownWrite();
+#ifdef MYMUDUO_HAS_TLS
+    if (tls_) {
+        if (!tls_->handshakeDone() || output_buffer_.readableBytes() > 0) {//握手完成、输出发完后再调用
+            return;
+        }
+        tls_->shutdown();
+    }
+#endif
+    if (!channel_.isWriting()) {
+        socket_.shutdownWrite();
     }
 }
 
 void TcpConnection::connectEstablished() {
     setState(Connected);
-    channel_->tie(shared_from_this());
-    channel_->enableReading();
+    channel_.tie(shared_from_this());
+    channel_.enableReading();
     connection_callback_(shared_from_this());
+#ifdef MYMUDUO_HAS_TLS
+    if (tls_) {//客户端在这里发出ClientHello
+        tlsHandshake();
+    }
+#endif
 }
 
 void TcpConnection::connectDestroyed() {
     if (state_ == Connected) {
         setState(Disconnected);
-        channel_->disableAll();
+        channel_.disableAll();
         connection_callback_(shared_from_this());
     }
-    channel_->remove();
+    channel_.remove();
 }
 
 void TcpConnection::handleRead(Timestamp receive_time) {
+#ifdef MYMUDUO_HAS_TLS
+    if (tls_) {
+        handleTlsRead(receive_time);
+        return;
+    }
+#endif
     int saved_errno;
-    ssize_t n = input_buffer_.readFd(channel_->fd(), &saved_errno);
+    ssize_t n = input_buffer_.readFd(channel_.fd(), &saved_errno);
+    FLIGHT_RECORD(Read, channel_.fd(), n);
     if (n > 0) {
         message_callback_(shared_from_this(), &input_buffer_, receive_time);
     } else if (n == 0) {
@@ -121,13 +192,26 @@ void TcpConnection::handleRead(Timestamp receive_time) {
 }
 
 void TcpConnection::handleWrite() {
-    if (channel_->isWriting()) {
+    if (channel_.isWriting()) {
         int saved_errno = 0;
-        ssize_t n = output_buffer_.writeFd(channel_->fd(), &saved_errno);
+#ifdef MYMUDUO_HAS_TLS
+        if (tls_ && (!tls_->handshakeDone() || output_buffer_.readableBytes() == 0)) {
+            tlsHandshake();
+            return;
+        }
+        ssize_t n = tls_ ? tls_->write(output_buffer_.peek(), output_buffer_.readableBytes(), &saved_errno)
+                         : output_buffer_.writeFd(channel_.fd(), &saved_errno);
+        if (tls_ && n < 0 && saved_errno == EAGAIN) {
+            return;
+        }
+#else
+        ssize_t n = output_buffer_.writeFd(channel_.fd(), &saved_errno);
+#endif
+        FLIGHT_RECORD(Write, channel_.fd(), n);
         if (n > 0) {
             output_buffer_.retrieve(n);
             if (output_buffer_.readableBytes() == 0) {
-                channel_->disableWriting();
+                channel_.disableWriting();
                 if (write_complete_callback_) {
                     loop_->queueInLoop(std::bind(write_complete_callback_, shared_from_this()));
                 }
@@ -139,14 +223,15 @@ void TcpConnection::handleWrite() {
             LOG_ERROR << "TcpConnection::handleWrite";
         }
     } else {
-        LOG_ERROR << "TcpConnection fd=" << channel_->fd() << " is down";
+        LOG_ERROR << "TcpConnection fd=" << channel_.fd() << " is down";
     }
 }
 
 void TcpConnection::handleClose() {
-    LOG_TRACE << "TcpConnection::handleClose fd=" << channel_->fd() << " state=" << state_;
+    LOG_BIN_TRACE("TcpConnection::handleClose fd={} state={}", channel_.fd(), state_.load());
+    FLIGHT_RECORD(Close, channel_.fd(), state_.load());
     setState(Disconnected);
-    channel_->disableAll();
+    channel_.disableAll();
     TcpConnectionPtr conn_ptr(shared_from_this());
     connection_callback_(conn_ptr);
     close_callback_(conn_ptr);
@@ -156,12 +241,12 @@ void TcpConnection::handleError() {
     int optval;
     socklen_t optlen = sizeof optval;
     int err = 0;
-    if (getsockopt(channel_->fd(), SOL_SOCKET, SO_ERROR, &optval, &optlen)) {
+    if (getsockopt(channel_.fd(), SOL_SOCKET, SO_ERROR, &optval, &optlen)) {
         err = errno;
     } else {
         err = optval;
     }
-    LOG_ERROR << "TcpConnection::handleError name:" << name_ << " - SO_ERROR:" << strerror(err);
+    LOG_ERROR << "TcpConnection::handleError name:" << name() << " - SO_ERROR:" << strerror(err);
 }
 void TcpConnection::forceClose() {
     if (state_ == Connected || state_ == Disconnecting) {
@@ -174,3 +259,45 @@ void TcpConnection::forceCloseInLoop() {
         handleClose();
     }
 }
+
+#ifdef MYMUDUO_HAS_TLS
+void TcpConnection::startTls(TlsContext *context, const std::string &server_name, std::string session_key) {
+    tls_ = std::make_unique<TlsFilter>(context, channel_.fd(), server_name, std::move(session_key));
+}
+
+void TcpConnection::handleTlsRead(Timestamp receive_time) {
+    if (!tls_->handshakeDone() && !tlsHandshake()) {
+        return;
+    }
+    int saved_errno = 0;
+    ssize_t n = tls_->read(&input_buffer_, &saved_errno);
+    FLIGHT_RECORD(Read, channel_.fd(), n);
+    if (n > 0) {
+        message_callback_(shared_from_this(), &input_buffer_, receive_time);
+    } else if (n == 0) {
+        handleClose();
+    } else if (saved_errno != EAGAIN) {//TLS出错后连接不能再用
+        LOG_ERROR << "TcpConnection::handleTlsRead " << name() << ":" << strerror(saved_errno);
+        handleClose();
+    }
+}
+
+bool TcpConnection::tlsHandshake() {
+    int ret = tls_->handshake();
+    if (ret < 0) {
+        LOG_ERROR << "TcpConnection::tlsHandshake " << name() << " failed";
+        handleClose();
+        return false;
+    }
+    bool want_write = ret == 0 ? tls_->wantWrite() : output_buffer_.readableBytes() > 0;
+    if (want_write && !channel_.isWriting()) {
+        channel_.enableWriting();
+    } else if (!want_write && channel_.isWriting()) {
+        channel_.disableWriting();
+    }
+    if (ret == 1 && !want_write && state_ == Disconnecting) {
+        shutdownInLoop();
+    }
+    return ret == 1;
+}
+#endif
@@ -1,43 +1,169 @@
 #include "net/TcpServer.h"
 #include "net/EventLoopThreadPool.h"
+#include <fcntl.h>
+#include <future>
 
 
 
 TcpServer::TcpServer(EventLoop *loop, const InetAddress &listen_addr,
                      std::string name, TcpServer::Option option)
-    : loop_(loop), ip_port_(listen_addr.toIpPort()),
-      name_(std::move(name)), acceptor_(new Acceptor(loop, listen_addr, option == ReusePort)),
+    : TcpServer(loop, listen_addr, std::move(name), {}, option) {}
+
+TcpServer::TcpServer(EventLoop *loop, const InetAddress &listen_addr,
+                     std::string name, std::vector<int> inherited_fds, TcpServer::Option option)
+    : loop_(loop), listen_addr_(listen_addr), ip_port_(listen_addr.toIpPort()),
+      name_(std::move(name)), option_(option), incoming_cpu_(false),
+      accept_budget_(Acceptor::DefaultAcceptBudget),
       thread_pool_(new EventLoopThreadPool(loop, name_)),
       connection_callback_(defaultConnectionCallback),
       message_callback_(defaultMessageCallback),
       write_complete_callback_(),
-      next_conn_id_(1),
-      started_(0) {
-    acceptor_->setNewConnectionCallback([this](auto &&fd, auto &&addr) { newConnection(std::forward<decltype(fd)>(fd), std::forward<decltype(addr)>(addr)); });
+      started_(0),
+      conn_name_prefix_(std::make_shared<const std::string>(name_ + "-" + ip_port_)),
+      draining_(false), drain_forced_(false) {
+    if (option != PerLoopReusePort && inherited_fds.size() > 1) {//只用第一个
+        for (size_t i = 1; i < inherited_fds.size(); ++i) {
+            SocketOps::close(inherited_fds[i]);
+        }
+        inherited_fds.resize(1);
+    }
+    if (option == NoReusePort || option == ReusePort) {
+        if (inherited_fds.empty()) {
+            acceptor_ = std::make_unique<Acceptor>(loop, listen_addr, option == ReusePort);
+        } else {
+            acceptor_ = std::make_unique<Acceptor>(loop, inherited_fds[0], false);
+        }
+        acceptor_->setNewConnectionsCallback([this](auto &&batch) { newConnections(batch); });
+    } else if (option == PerLoopExclusive) {
+        if (inherited_fds.empty()) {
+            shared_socket_ = std::make_unique<Socket>(SocketOps::createNonblockingSocket(listen_addr.family()));
+            shared_socket_->setReuseAddr(true);
+            shared_socket_->bind(listen_addr);
+        } else {
+            shared_socket_ = std::make_unique<Socket>(inherited_fds[0]);
+        }
+    } else {
+        inherited_fds_ = std::move(inherited_fds);
+    }
 }
 
 TcpServer::~TcpServer() {
-    for (auto &item: connections_) {
-        TcpConnectionPtr conn(item.second);
-        item.second.reset();
-        conn->getLoop()->runInLoop([conn]() mutable { conn->connectDestroyed(); });
+    for (auto &acceptor: loop_acceptors_) {//每个Acceptor在自己的loop中销毁
+        if (!acceptor) {
+            continue;
+        }
+        EventLoop *io_loop = acceptor->getLoop();
+        if (io_loop->isInLoopThread()) {
+            acceptor.reset();
+        } else {
+            std::promise<void> done;
+            io_loop->runInLoop([&acceptor, &done] {
+                acceptor.reset();
+                done.set_value();
+            });
+            done.get_future().wait();
+        }
+    }
+    for (auto &item: shards_) {//各分片的连接在各自loop中销毁，等待完成后线程池才能析构
+        ShardPtr shard = item.second;
+        auto teardown = [shard] {
+            for (auto &conn: shard->connections) {
+                conn.second->connectDestroyed();
+            }
+            shard->connections.clear();
+            shard->live = 0;
+            shard->thread_pool = nullptr;
+        };
+        if (shard->loop->isInLoopThread()) {
+            teardown();
+        } else {
+            std::promise<void> done;
+            shard->loop->runInLoop([&teardown, &done] {
+                teardown();
+                done.set_value();
+            });
+            done.get_future().wait();
+        }
     }
 }
 
 void TcpServer::start() {
     if (started_++ == 0) {
         thread_pool_->start(thread_init_callback_);
-        loop_->runInLoop([acceptor = acceptor_.get()] { acceptor->listen(); });
+        uint64_t shard_index = 0;
+        for (EventLoop *io_loop: thread_pool_->getAllLoops()) {
+            auto shard = std::make_shared<Shard>();
+            shard->loop = io_loop;
+            shard->index = shard_index++;
+            shard->pool = std::make_shared<ConnectionPool>();
+            shard->thread_pool = thread_pool_.get();
+            shard->idle_predicate = idle_predicate_;
+            shards_[io_loop] = shard;
+        }
+        if (acceptor_) {
+            acceptor_->setAcceptBudget(accept_budget_);
+            loop_->runInLoop([acceptor = acceptor_.get()] { acceptor->listen(); });
+            return;
+        }
+        if (shared_socket_) {
+            shared_socket_->listen();
+        }
+        std::vector<EventLoop *> loops = thread_pool_->getAllLoops();
+        size_t num_acceptors = std::max(loops.size(), inherited_fds_.size());
+        for (size_t i = 0; i < num_acceptors; ++i) {
+            EventLoop *io_loop = loops[i % loops.size()];
+            std::unique_ptr<Acceptor> acceptor;
+            if (shared_socket_) {
+                int fd = ::fcntl(shared_socket_->getFd(), F_DUPFD_CLOEXEC, 0);
+                acceptor = std::make_unique<Acceptor>(io_loop, fd, true);
+            } else if (i < inherited_fds_.size()) {//继承的socket已经在reuseport组中
+                acceptor = std::make_unique<Acceptor>(io_loop, inherited_fds_[i], false);
+            } else {
+                acceptor = std::make_unique<Acceptor>(io_loop, listen_addr_, true);
+            }
+            acceptor->setAcceptBudget(accept_budget_);
+            acceptor->setNewConnectionCallback([this, io_loop](int sockfd, const InetAddress &peer_addr) {
+                thread_pool_->acquireConnection(io_loop);
+                establishConnection(io_loop, sockfd, peer_addr);
+            });
+            bool incoming_cpu = incoming_cpu_ && !shared_socket_;
+            io_loop->runInLoop([acceptor = acceptor.get(), incoming_cpu] {
+                if (incoming_cpu) {
+                    acceptor->setIncomingCpu(CpuAffinity::currentCpu());
+                }
+                acceptor->listen();
+            });
+            loop_acceptors_.emplace_back(std::move(acceptor));
+        }
+        inherited_fds_.clear();
     }
 }
 
-void TcpServer::newConnection(int sockfd, const InetAddress &peer_addr) {
-    EventLoop *io_loop = thread_pool_->getNextLoop();
-    char buf[64] = {0};
-    snprintf(buf, sizeof(buf), "-%s#%d", ip_port_.c_str(), next_conn_id_);
-    ++next_conn_id_;
-    std::string conn_name = name_ + buf;
-    LOG_TRACE << "TcpServer::newConnection " << name_ << " - new connection " << conn_name << " from %s" << peer_addr.toIpPort();
+void TcpServer::newConnections(std::vector<Acceptor::AcceptedConnection> &batch) {
+    //按目标loop分组，每个loop只投递一个任务
+    using Group = std::pair<EventLoop *, std::vector<Acceptor::AcceptedConnection>>;
+    std::vector<Group> groups;
+    for (Acceptor::AcceptedConnection &accepted: batch) {
+        EventLoop *io_loop = thread_pool_->getLoopForConnection(accepted.peer_addr);
+        auto it = std::find_if(groups.begin(), groups.end(), [io_loop](const Group &g) { return g.first == io_loop; });
+        if (it == groups.end()) {
+            it = groups.emplace(groups.end(), io_loop, Group::second_type());
+        }
+        it->second.push_back(accepted);
+    }
+    for (Group &group: groups) {//在io线程中构造连接，使其Socket、Channel、Buffer分配在该线程所在的NUMA节点
+        EventLoop *io_loop = group.first;
+        io_loop->runInLoop([this, io_loop, conns = std::move(group.second)] {
+            for (const Acceptor::AcceptedConnection &accepted: conns) {
+                establishConnection(io_loop, accepted.fd, accepted.peer_addr);
+            }
+        });
+    }
+}
+
+void TcpServer::establishConnection(EventLoop *io_loop, int sockfd, const InetAddress &peer_addr) {
+    const ShardPtr &shard = shards_.at(io_loop);//start后shards_只读，无需加锁
+    uint64_t id = (shard->index << 48) | ++shard->next_seq;
     sockaddr_in local{};
     //memset(&local, 0, sizeof(local));
     socklen_t addrlen = sizeof(local);
@@ -45,25 +171,153 @@ void TcpServer::newConnection(int sockfd, const InetAddress &peer_addr) {
         LOG_ERROR << "sockets::getLocalAddr:" << strerror(errno);
     }
     InetAddress local_addr(local);
-    TcpConnectionPtr conn(new TcpConnection(io_loop, conn_name, sockfd, local_addr, peer_addr));
-    connections_[conn_name] = conn;
+    TcpConnectionPtr conn = std::allocate_shared<TcpConnection>(ConnectionPool::Allocator<TcpConnection>(shard->pool),
+                                                                 io_loop, id, conn_name_prefix_, sockfd,
+                                                                 local_addr, peer_addr, shard->pool.get());
+    LOG_TRACE << "TcpServer::newConnection " << name_ << " - new connection " << conn->name() << " from " << peer_addr.toIpPort();
     conn->setConnectionCallback(connection_callback_);
     conn->setMessageCallback(message_callback_);
     conn->setWriteCompleteCallback(write_complete_callback_);
-    conn->setCloseCallback([this](const TcpConnectionPtr &conn_ptr) { removeConnection(conn_ptr); });
-    io_loop->runInLoop([conn]() mutable { conn->connectEstablished(); });
+    //连接持有分片的weak_ptr，分片已随TcpServer销毁时其中的连接都已connectDestroyed
+    conn->setCloseCallback([weak_shard = std::weak_ptr<Shard>(shard)](const TcpConnectionPtr &conn_ptr) {
+        if (ShardPtr s = weak_shard.lock()) {
+            removeConnection(s.get(), conn_ptr);
+        }
+    });
+    shard->connections[id] = conn;
+    ++shard->live;
+#ifdef MYMUDUO_HAS_TLS
+    if (tls_context_ != nullptr) {
+        conn->startTls(tls_context_);
+    }
+#endif
+    conn->connectEstablished();
+    if (shard->draining) {//drain开始后才建立的连接
+        shutdownIfIdle(shard.get(), conn);
+    }
 }
 
-void TcpServer::removeConnection(const TcpConnectionPtr &conn) {
-    loop_->runInLoop([this, conn] { removeConnectionInLoop(conn); });
+void TcpServer::removeConnection(Shard *shard, const TcpConnectionPtr &conn) {
+    LOG_TRACE << "TcpServer::removeConnection connection " << conn->name();
+    if (shard->connections.erase(conn->id()) > 0) {
+        --shard->live;
+    }
+    if (shard->thread_pool != nullptr) {
+        shard->thread_pool->releaseConnection(shard->loop);
+    }
+    shard->loop->queueInLoop([conn]() mutable { conn->connectDestroyed(); });
 }
 
-void TcpServer::removeConnectionInLoop(const TcpConnectionPtr &conn) {
-    LOG_TRACE << "TcpServer::removeConnectionInLoop " << name_.c_str() << " - connection " << conn->name();
-    connections_.erase(conn->name());
-    EventLoop *ioLoop = conn->getLoop();
-    ioLoop->queueInLoop([conn] () mutable { conn->connectDestroyed(); });
+void TcpServer::shutdownIfIdle(Shard *shard, const TcpConnectionPtr &conn) {
+    if (conn->connect() && conn->idle() && (!shard->idle_predicate || shard->idle_predicate(conn))) {
+        conn->shutdown();
+    }
 }
+
+void TcpServer::drain(double timeout, DrainCallback progress, double report_interval) {
+    if (report_interval <= 0) {
+        LOG_ERROR << "TcpServer::drain " << name_ << " - report_interval must be positive:" << report_interval;
+        return;
+    }
+    loop_->runInLoop([this, timeout, progress = std::move(progress), report_interval] {
+        if (draining_) {
+            return;
+        }
+        draining_ = true;
+        drain_callback_ = progress;
+        drain_deadline_ = Timestamp::now() + timeout;
+        stopAccepting();
+        for (auto &item: shards_) {
+            ShardPtr shard = item.second;
+            shard->loop->runInLoop([shard] {
+                shard->draining = true;
+                for (auto &conn: shard->connections) {
+                    shutdownIfIdle(shard.get(), conn.second);
+                }
+            });
+        }
+        drain_timer_ = loop_->runEvery(report_interval, [this] { checkDrain(); });
+    });
+}
+
+void TcpServer::stopAccepting() {
+    //Acceptor可能正处于自己的回调中，放到队列里销毁
+    if (acceptor_) {
+        loop_->queueInLoop([acceptor = std::shared_ptr<Acceptor>(std::move(acceptor_))] {});
+    }
+    for (auto &acceptor: loop_acceptors_) {
+        if (acceptor) {
+            EventLoop *io_loop = acceptor->getLoop();
+            io_loop->queueInLoop([acceptor = std::shared_ptr<Acceptor>(std::move(acceptor))] {});
+        }
+    }
+    shared_socket_.reset();
+}
+
+void TcpServer::checkDrain() {
+    size_t remaining = numConnections();
+    bool done = remaining == 0;
+    if (!done && !drain_forced_ && !(Timestamp::now() < drain_deadline_)) {
+        LOG_WARN << "TcpServer::drain " << name_ << " - deadline reached, force closing " << remaining << " connections";
+        drain_forced_ = true;
+        for (auto &item: shards_) {
+            ShardPtr shard = item.second;
+            shard->loop->runInLoop([shard] {
+                for (auto &conn: shard->connections) {
+                    conn.second->forceClose();
+                }
+            });
+        }
+    } else if (!done && !drain_forced_) {//之前忙碌的连接可能已经空闲
+        for (auto &item: shards_) {
+            ShardPtr shard = item.second;
+            shard->loop->runInLoop([shard] {
+                for (auto &conn: shard->connections) {
+                    shutdownIfIdle(shard.get(), conn.second);
+                }
+            });
+        }
+    }
+    if (drain_callback_) {
+        drain_callback_(remaining, done);
+    }
+    if (done) {
+        loop_->cancel(drain_timer_);
+    }
+}
+
+size_t TcpServer::numConnections() const {
+    size_t n = 0;
+    for (const auto &item: shards_) {
+        n += item.second->live;
+    }
+    return n;
+}
+
+std::vector<int> TcpServer::listenFds() const {
+    std::vector<int> fds;
+    if (acceptor_) {
+        fds.push_back(acceptor_->listenFd());
+    } else if (shared_socket_) {
+        fds.push_back(shared_socket_->getFd());
+    } else {
+        for (const auto &acceptor: loop_acceptors_) {
+            if (acceptor) {
+                fds.push_back(acceptor->listenFd());
+            }
+        }
+    }
+    return fds;
+}
+
 void TcpServer::setThreadNum(int num) {
     thread_pool_->setThreadNum(num);
 }
+
+void TcpServer::setThreadAffinity(std::vector<CpuAffinity::CpuSet> cpu_sets) {
+    thread_pool_->setThreadAffinity(std::move(cpu_sets));
+}
+
+void TcpServer::setDispatchPolicy(EventLoopThreadPool::DispatchPolicy policy) {
+    thread_pool_->setDispatchPolicy(policy);
+}
@@ -0,0 +1,76 @@
+#include "net/TimerPool.h"
+#include "base/Logging.h"
+#include "net/Timer.h"
+#include <new>
+
+struct TimerPool::Slot {
+    alignas(Timer) unsigned char storage[sizeof(Timer)];//Timer必须在首位，release时由Timer*得到Slot*
+    std::atomic_uint32_t generation{0};
+    uint32_t index = 0;
+
+    Timer *timer() {
+        return reinterpret_cast<Timer *>(storage);
+    }
+};
+
+TimerPool::TimerPool() : num_slots_(0) {}
+
+TimerPool::~TimerPool() {
+    for (uint32_t i = 0; i < num_slots_; ++i) {//销毁仍在使用中的定时器
+        Slot *slot = slotAt(i);
+        if (slot->generation & 1) {
+            slot->timer()->~Timer();
+        }
+    }
+}
+
+TimerPool::Slot *TimerPool::slotAt(uint32_t index) const {
+    return &chunks_[index >> ChunkBits][index & (ChunkSize - 1)];
+}
+
+Timer *TimerPool::allocate(TimerCallback cb, Timestamp when, double interval, double slack, TimerId *timer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = num_slots_;
+        uint32_t chunk = index >> ChunkBits;
+        if (chunk >= MaxChunks) {
+            LOG_FATAL << "TimerPool: too many timers " << index;
+        }
+        if (!chunks_[chunk]) {
+            chunks_[chunk] = std::make_unique<Slot[]>(ChunkSize);
+            for (uint32_t i = 0; i < ChunkSize; ++i) {
+                chunks_[chunk][i].index = index + i;
+            }
+        }
+        num_slots_.store(index + 1, std::memory_order_release);
+    }
+    Slot *slot = slotAt(index);
+    auto *timer = new (slot->storage) Timer(std::move(cb), when, interval, slack);
+    uint32_t generation = slot->generation.load(std::memory_order_relaxed) + 1;
+    slot->generation.store(generation, std::memory_order_release);
+    *timer_id = TimerId(index, generation);
+    return timer;
+}
+
+void TimerPool::release(Timer *timer) {
+    auto *slot = reinterpret_cast<Slot *>(timer);
+    timer->~Timer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->generation.fetch_add(1, std::memory_order_release);
+    free_slots_.push_back(slot->index);
+}
+
+Timer *TimerPool::get(TimerId timer_id) const {
+    if ((timer_id.generation_ & 1) == 0 || timer_id.index_ >= num_slots_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    Slot *slot = slotAt(timer_id.index_);
+    if (slot->generation.load(std::memory_order_acquire) != timer_id.generation_) {
+        return nullptr;
+    }
+    return slot->timer();
+}
@@ -1,8 +1,11 @@
 #include "net/TimerQueue.h"
+#include "base/FlightRecorder.h"
 #include "base/Logging.h"
 #include "net/EventLoop.h"
+#include "net/OrderedTimerQueue.h"
 #include "net/Timer.h"
 #include "net/TimerId.h"
+#include "net/TimerWheel.h"
 
 #include <sys/timerfd.h>
 #include <unistd.h>
@@ -15,16 +18,6 @@ int createTimerfd() {//创建一个timerfd
     return timerfd;
 }
 
-struct timespec howMuchTimeFromNow(Timestamp when) {//返回给定Timestamp距离现在还有多长时间
-    int64_t microseconds = when.microSecondsSinceEpoch() - Timestamp::now().microSecondsSinceEpoch();
-    if (microseconds < 100) {
-        microseconds = 100;
-    }
-    struct timespec ts {};
-    ts.tv_sec = static_cast<time_t>(microseconds / 1000);
-    ts.tv_nsec = static_cast<long>(microseconds % 1000 * 1000);
-    return ts;
-}
 
 void readTimerfd(int timerfd, Timestamp now) {
     uint64_t howmany;
@@ -38,41 +31,53 @@ void readTimerfd(int timerfd, Timestamp now) {
 void resetTimerfd(int timerfd, Timestamp expiration) {//将timerfd的超时时间设置到expiration
     struct itimerspec new_value {};
     struct itimerspec old_value {};
-    new_value.it_value = howMuchTimeFromNow(expiration);
-    int ret = ::timerfd_settime(timerfd, 0, &new_value, &old_value);
+    //Timestamp与timerfd都使用CLOCK_MONOTONIC，直接设置绝对时间
+    new_value.it_value.tv_sec = static_cast<time_t>(expiration.nanoSeconds() / Timestamp::NanoSecondsPerSecond);
+    new_value.it_value.tv_nsec = static_cast<long>(expiration.nanoSeconds() % Timestamp::NanoSecondsPerSecond);
+    int ret = ::timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &new_value, &old_value);
     if (ret) {
         LOG_ERROR << "timerfd_settime()";
     }
 }
 
-TimerQueue::TimerQueue(EventLoop *loop)
-    : loop_(loop), timerfd_(createTimerfd()),
-      channel_(loop, timerfd_),
-      timers_(), calling_expired_timers_(false) {
-    channel_.setReadCallback([this](Timestamp) { handleRead(); });//有超时事件发生
-    channel_.enableReading();
+TimerQueue *TimerQueue::newTimerQueue(EventLoop *loop, Type type, bool use_timerfd) {
+    if (type == Wheel) {
+        return new TimerWheel(loop, use_timerfd);
+    }
+    return new OrderedTimerQueue(loop, use_timerfd);
+}
+
+TimerQueue::TimerQueue(EventLoop *loop, bool use_timerfd)
+    : loop_(loop), timerfd_(use_timerfd ? createTimerfd() : -1),
+      channel_(loop, timerfd_), default_slack_(0.0) {
+    if (timerfd_ >= 0) {
+        channel_.setReadCallback([this](Timestamp receive_time) { handleRead(receive_time); });//有超时事件发生
+        channel_.enableReading();
+    }
 }
 
 TimerQueue::~TimerQueue() {
-    channel_.disableAll();
-    channel_.remove();
-    ::close(timerfd_);
-    for (const Entry &timer: timers_) {
-        delete timer.second;
+    if (timerfd_ >= 0) {
+        channel_.disableAll();
+        channel_.remove();
+        ::close(timerfd_);
     }
 }
 
-TimerId TimerQueue::addTimer(TimerCallback cb, Timestamp when, double interval) {
-    auto *timer = new Timer(std::move(cb), when, interval);//创建一个Timer
+TimerId TimerQueue::addTimer(TimerCallback cb, Timestamp when, double interval, double slack) {
+    TimerId timer_id;
+    Timer *timer = pool_.allocate(std::move(cb), when, interval, slack < 0.0 ? default_slack_.load() : slack, &timer_id);
     loop_->runInLoop([this, timer] { addTimerInLoop(timer); });
-    return {timer, timer->sequence()};
+    return timer_id;
 }
 
 void TimerQueue::addTimerInLoop(Timer *timer) {
-    bool earliest_changed = insert(timer);//插入
-    if (earliest_changed) {//如果插入的Timer的到期时间小于已存在的Timer的最小到期时间
-        resetTimerfd(timerfd_, timer->expiration());//设置timerfd的到期时间为该timer
+    if (timer->canceled()) {//加入之前已被cancel
+        pool_.release(timer);
+        return;
     }
+    insert(timer);
+    rearm();
 }
 
 void TimerQueue::cancel(TimerId timerId) {
@@ -80,73 +85,56 @@ void TimerQueue::cancel(TimerId timerId) {
 }
 
 void TimerQueue::cancelInLoop(TimerId timer_id) {
-    ActiveTimer timer(timer_id.timer_, timer_id.sequence_);
-    auto it = active_timers_.find(timer);
-    if (it != active_timers_.end()) {
-        size_t n = timers_.erase(Entry(it->first->expiration(), it->first));
-        delete it->first;
-        active_timers_.erase(it);
-    } else if (calling_expired_timers_) {
-        canceling_timers_.insert(timer);
+    Timer *timer = pool_.get(timer_id);
+    if (timer == nullptr) {//已执行完或已取消
+        return;
+    }
+    if (erase(timer)) {
+        pool_.release(timer);
+        rearm();
+    } else {//正在执行或尚未加入队列
+        timer->cancel();
     }
 }
 
-void TimerQueue::handleRead() {//超时事件发送，执行回调
-    Timestamp now(Timestamp::now());
+void TimerQueue::handleRead(Timestamp now) {//超时事件发送，执行回调，now为本轮poll返回的时间
     readTimerfd(timerfd_, now);
-
-    std::vector<Entry> expired = getExpired(now);//获取已到期的Timer
-    calling_expired_timers_ = true;
-    canceling_timers_.clear();
-    for (const Entry &it: expired) {
-        it.second->run();//执行已超时的Timer的回调
-    }
-    calling_expired_timers_ = false;
-    reset(expired, now);
+    armed_ = Timestamp();
+    processExpired(now);
 }
 
-std::vector<TimerQueue::Entry> TimerQueue::getExpired(Timestamp now) {//返回已到期的Timer
-    std::vector<Entry> expired;
-    Entry sentry(now, reinterpret_cast<Timer *>(UINTPTR_MAX));
-    auto end = timers_.lower_bound(sentry);                 //找到第一个 > now 的值
-    std::copy(timers_.begin(), end, back_inserter(expired));//将小于等于now的放入expired中
-    timers_.erase(timers_.begin(), end);                    //删除
+void TimerQueue::processExpired(Timestamp now) {
 
-    for (const Entry &it: expired) {
-        ActiveTimer timer(it.second, it.second->sequence());
-        size_t n = active_timers_.erase(timer);//从active_timers中删除
+    expired_.clear();
+    takeExpired(now, &expired_);//获取已到期的Timer
+    if (!expired_.empty()) {
+        FLIGHT_RECORD(TimerFire, -1, static_cast<int64_t>(expired_.size()));
     }
-    return expired;
-}
-
-void TimerQueue::reset(const std::vector<Entry> &expired, Timestamp now) {
-    Timestamp next_expire;
-    for (const Entry &it: expired) {//遍历已到期的Timers
-        ActiveTimer timer(it.second, it.second->sequence());
-        if (it.second->repeat() && canceling_timers_.find(timer) == canceling_timers_.end()) {//如果timer是重复的，且不在canceling中
-            it.second->restart(now);                                                          //重置timer
-            insert(it.second);                                                                //插入
-        } else {
-            delete it.second;//否则删除
+    for (Timer *timer: expired_) {
+        if (!timer->canceled()) {//可能被同一批中之前的回调取消
+            timer->run();//执行已超时的Timer的回调
         }
     }
-    if (!timers_.empty()) {
-        next_expire = timers_.begin()->second->expiration();
-    }
 
-    if (next_expire.microSecondsSinceEpoch() > 0) {
-        resetTimerfd(timerfd_, next_expire);//设置到期时间为下一个Timer
+    for (Timer *timer: expired_) {//遍历已到期的Timers
+        if (timer->repeat() && !timer->canceled()) {//如果timer是重复的，且没有被取消
+            timer->restart(now);//重置timer
+            insert(timer);      //插入
+        } else {
+            pool_.release(timer);//否则放回池中
+        }
     }
+    expired_.clear();
+    rearm();
 }
 
-bool TimerQueue::insert(Timer *timer) {
-    bool earliest_changed = false;
-    Timestamp when = timer->expiration();
-    auto it = timers_.begin();
-    if (it == timers_.end() || when < it->first) {
-        earliest_changed = true;
+void TimerQueue::rearm() {//最早的deadline提前时重新设置timerfd，新定时器的窗口包含已设置的时间时不需要重设，推后时只会多一次空唤醒
+    if (timerfd_ < 0) {//由EventLoop根据nextWakeup计算poll超时
+        return;
+    }
+    Timestamp next_expire = earliest();
+    if (next_expire.valid() && (!armed_.valid() || next_expire < armed_)) {
+        resetTimerfd(timerfd_, next_expire);
+        armed_ = next_expire;
     }
-    timers_.insert(Entry(when, timer));//插入timer
-    active_timers_.insert(ActiveTimer(timer, timer->sequence()));
-    return earliest_changed;
 }
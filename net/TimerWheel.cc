@@ -0,0 +1,147 @@
+#include "net/TimerWheel.h"
+#include "net/Timer.h"
+
+TimerWheel::TimerWheel(EventLoop *loop, bool use_timerfd)
+    : TimerQueue(loop, use_timerfd), current_tick_(Timestamp::now().nanoSeconds() / NanoSecondsPerTick),
+      slots_(), occupied_(), size_(0) {}
+
+int64_t TimerWheel::tickOf(Timestamp when) {
+    return (when.nanoSeconds() + NanoSecondsPerTick - 1) / NanoSecondsPerTick;
+}
+
+int64_t TimerWheel::expireTickOf(const Timer *timer) {
+    int64_t first = tickOf(timer->expiration());
+    int64_t last = timer->deadline().nanoSeconds() / NanoSecondsPerTick;
+    if (last <= first) {
+        return first;
+    }
+    //取[first, last]中末尾0最多的tick：last保留与first-1相同的高位，再保留第一个不同的位
+    int shift = 63 - __builtin_clzll(static_cast<uint64_t>((first - 1) ^ last));
+    return (last >> shift) << shift;
+}
+
+void TimerWheel::insert(Timer *timer) {
+    ++size_;
+    int64_t expire_tick = expireTickOf(timer);
+    place(timer, expire_tick > current_tick_ ? expire_tick : current_tick_ + 1);//已过期的在下一个tick执行
+}
+
+void TimerWheel::place(Timer *timer, int64_t expire_tick) {
+    //放在第一个能容纳的层：该层上到期槽与当前槽相差小于64
+    int level = 0;
+    int64_t slot_tick = expire_tick;
+    while (level < Levels - 1 && slot_tick - (current_tick_ >> (SlotBits * level)) >= Slots) {
+        ++level;
+        slot_tick = expire_tick >> (SlotBits * level);
+    }
+    int64_t current = current_tick_ >> (SlotBits * level);
+    if (slot_tick - current >= Slots) {//超出最高层范围，先放在最后一个槽
+        slot_tick = current + Slots - 1;
+    }
+    int slot = static_cast<int>(slot_tick & (Slots - 1));
+    timer->index_ = level * Slots + slot;
+    timer->prev_ = nullptr;
+    timer->next_ = slots_[level][slot];
+    if (timer->next_ != nullptr) {
+        timer->next_->prev_ = timer;
+    }
+    slots_[level][slot] = timer;
+    occupied_[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::unlink(Timer *timer) {
+    int level = timer->index_ / Slots;
+    int slot = timer->index_ % Slots;
+    if (timer->prev_ != nullptr) {
+        timer->prev_->next_ = timer->next_;
+    } else {
+        slots_[level][slot] = timer->next_;
+    }
+    if (timer->next_ != nullptr) {
+        timer->next_->prev_ = timer->prev_;
+    }
+    if (slots_[level][slot] == nullptr) {
+        occupied_[level] &= ~(uint64_t(1) << slot);
+    }
+    timer->prev_ = timer->next_ = nullptr;
+    timer->index_ = -1;
+}
+
+bool TimerWheel::erase(Timer *timer) {
+    if (timer->index_ < 0) {
+        return false;
+    }
+    unlink(timer);
+    --size_;
+    return true;
+}
+
+int64_t TimerWheel::nextEventTick() const {
+    int64_t next = -1;
+    for (int level = 0; level < Levels; ++level) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+        //从当前槽的下一个槽开始找第一个非空槽
+        int shift = SlotBits * level;
+        int64_t current = current_tick_ >> shift;
+        int start = static_cast<int>((current + 1) & (Slots - 1));
+        uint64_t rotated = (occupied_[level] >> start) | (start == 0 ? 0 : occupied_[level] << (Slots - start));
+        int64_t tick = (current + 1 + __builtin_ctzll(rotated)) << shift;
+        if (next < 0 || tick < next) {
+            next = tick;
+        }
+    }
+    return next;
+}
+
+void TimerWheel::takeExpired(Timestamp now, std::vector<Timer *> *expired) {
+    int64_t now_tick = now.nanoSeconds() / NanoSecondsPerTick;
+    int64_t tick;
+    while ((tick = nextEventTick()) >= 0 && tick <= now_tick) {
+        current_tick_ = tick;
+        for (int level = Levels - 1; level > 0; --level) {//从高层到低层重新放置，放下来的定时器可能在本tick到期
+            int shift = SlotBits * level;
+            if ((tick & ((int64_t(1) << shift) - 1)) != 0) {
+                continue;
+            }
+            int slot = static_cast<int>((tick >> shift) & (Slots - 1));
+            Timer *timer = slots_[level][slot];
+            slots_[level][slot] = nullptr;
+            occupied_[level] &= ~(uint64_t(1) << slot);
+            while (timer != nullptr) {
+                Timer *next = timer->next_;
+                int64_t expire_tick = expireTickOf(timer);
+                if (expire_tick <= tick) {
+                    timer->prev_ = timer->next_ = nullptr;
+                    timer->index_ = -1;
+                    --size_;
+                    expired->push_back(timer);
+                } else {
+                    place(timer, expire_tick);
+                }
+                timer = next;
+            }
+        }
+        int slot = static_cast<int>(tick & (Slots - 1));
+        Timer *timer = slots_[0][slot];
+        slots_[0][slot] = nullptr;
+        occupied_[0] &= ~(uint64_t(1) << slot);
+        while (timer != nullptr) {
+            Timer *next = timer->next_;
+            timer->prev_ = timer->next_ = nullptr;
+            timer->index_ = -1;
+            --size_;
+            expired->push_back(timer);
+            timer = next;
+        }
+    }
+    if (now_tick > current_tick_) {
+        current_tick_ = now_tick;
+    }
+}
+
+Timestamp TimerWheel::earliest() const {
+    int64_t tick = nextEventTick();
+    return tick < 0 ? Timestamp() : Timestamp(tick * NanoSecondsPerTick);
+}
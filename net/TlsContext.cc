@@ -0,0 +1,106 @@
+#include "net/TlsContext.h"
+#include "base/Logging.h"
+#include "net/TlsFilter.h"
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+namespace {
+    std::string lastError() {
+        char buf[256];
+        ERR_error_string_n(ERR_get_error(), buf, sizeof(buf));
+        ERR_clear_error();
+        return buf;
+    }
+}// namespace
+
+TlsContext::TlsContext(Mode mode, bool kernel_tls)
+    : mode_(mode), ctx_(SSL_CTX_new(mode == Server ? TLS_server_method() : TLS_client_method())),
+      verify_peer_(false), handshakes_(0), resumed_(0), kernel_tls_(0) {
+    if (ctx_ == nullptr) {
+        LOG_FATAL << "TlsContext SSL_CTX_new:" << lastError();
+    }
+    SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+    //发送失败后从TcpConnection的输出Buffer重试，地址可能已经变化
+    SSL_CTX_set_mode(ctx_, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                                   SSL_MODE_RELEASE_BUFFERS);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+    SSL_CTX_set_options(ctx_, SSL_OP_IGNORE_UNEXPECTED_EOF);//没有close_notify的EOF按正常关闭处理
+#endif
+#ifdef SSL_OP_ENABLE_KTLS
+    if (kernel_tls) {
+        SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+    }
+#endif
+    if (mode == Server) {
+        static const unsigned char SessionIdContext[] = "mymuduo";
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_set_session_id_context(ctx_, SessionIdContext, sizeof(SessionIdContext) - 1);
+        SSL_CTX_set_num_tickets(ctx_, 1);
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx_, [](SSL *ssl, SSL_SESSION *session) -> int {
+            auto *filter = static_cast<TlsFilter *>(SSL_get_app_data(ssl));
+            if (filter == nullptr || filter->session_key_.empty()) {
+                return 0;
+            }
+            filter->context_->putSession(filter->session_key_, session);
+            return 1;//引用交给缓存
+        });
+    }
+}
+
+TlsContext::~TlsContext() {
+    for (auto &item: sessions_) {
+        SSL_SESSION_free(item.second);
+    }
+    SSL_CTX_free(ctx_);
+}
+
+bool TlsContext::loadCertificate(const std::string &cert_file, const std::string &key_file) {
+    if (SSL_CTX_use_certificate_chain_file(ctx_, cert_file.c_str()) != 1 ||
+        SSL_CTX_use_PrivateKey_file(ctx_, key_file.c_str(), SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(ctx_) != 1) {
+        LOG_ERROR << "TlsContext::loadCertificate " << cert_file << ":" << lastError();
+        return false;
+    }
+    return true;
+}
+
+bool TlsContext::loadVerifyLocations(const std::string &ca_file) {
+    if (SSL_CTX_load_verify_locations(ctx_, ca_file.c_str(), nullptr) != 1) {
+        LOG_ERROR << "TlsContext::loadVerifyLocations " << ca_file << ":" << lastError();
+        return false;
+    }
+    SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER | (mode_ == Server ? SSL_VERIFY_FAIL_IF_NO_PEER_CERT : 0), nullptr);
+    verify_peer_ = true;
+    return true;
+}
+
+SSL_SESSION *TlsContext::getSession(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(key);
+    if (it == sessions_.end()) {
+        return nullptr;
+    }
+    SSL_SESSION_up_ref(it->second);
+    return it->second;
+}
+
+void TlsContext::putSession(const std::string &key, SSL_SESSION *session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SSL_SESSION *&slot = sessions_[key];
+    if (slot != nullptr) {
+        SSL_SESSION_free(slot);
+    }
+    slot = session;
+}
+
+void TlsContext::onHandshakeDone(bool resumed, bool kernel_send) {
+    handshakes_.fetch_add(1, std::memory_order_relaxed);
+    if (resumed) {
+        resumed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (kernel_send) {
+        kernel_tls_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,152 @@
+#include "net/TlsFilter.h"
+#include "base/Logging.h"
+#include "net/Buffer.h"
+#include "net/SocketOps.h"
+#include "net/TlsContext.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <climits>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+TlsFilter::TlsFilter(TlsContext *context, int fd, const std::string &server_name, std::string session_key)
+    : context_(context), ssl_(SSL_new(context->native())), session_key_(std::move(session_key)),
+      handshake_done_(false), want_write_(false), kernel_send_(false), kernel_receive_(false) {
+    if (ssl_ == nullptr) {
+        LOG_FATAL << "TlsFilter SSL_new failed";
+    }
+    SSL_set_fd(ssl_, fd);//BIO_NOCLOSE，fd仍由Socket关闭
+    SSL_set_app_data(ssl_, this);
+    if (context->mode() == TlsContext::Client) {
+        SSL_set_connect_state(ssl_);
+        if (!server_name.empty()) {
+            SSL_set_tlsext_host_name(ssl_, server_name.c_str());
+            if (context->verifyPeer()) {
+                SSL_set1_host(ssl_, server_name.c_str());
+            }
+        } else if (context->verifyPeer()) {//没有服务器名时证书必须包含对端IP，否则任何同一CA签发的证书都能通过
+            sockaddr_in peer = SocketOps::getPeerAddr(fd);
+            char ip[INET_ADDRSTRLEN] = {0};
+            if (::inet_ntop(AF_INET, &peer.sin_addr, ip, static_cast<socklen_t>(sizeof(ip))) == nullptr ||
+                X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl_), ip) != 1) {
+                LOG_ERROR << "TlsFilter cannot verify peer address, fd " << fd;
+                SSL_set_verify(ssl_, SSL_VERIFY_PEER, [](int, X509_STORE_CTX *) { return 0; });//拒绝任何证书
+            }
+        }
+        if (!session_key_.empty()) {
+            if (SSL_SESSION *session = context->getSession(session_key_)) {
+                SSL_set_session(ssl_, session);
+                SSL_SESSION_free(session);
+            }
+        }
+    } else {
+        SSL_set_accept_state(ssl_);
+    }
+}
+
+TlsFilter::~TlsFilter() {
+    if (handshake_done_) {
+        //未发出close_notify时SSL_free会使会话失效；致命错误在发送alert时已使其失效，这里保留会话供复用
+        SSL_set_shutdown(ssl_, SSL_get_shutdown(ssl_) | SSL_SENT_SHUTDOWN);
+    }
+    SSL_free(ssl_);
+}
+
+int TlsFilter::handshake() {
+    if (handshake_done_) {
+        return 1;
+    }
+    errno = 0;
+    int ret = SSL_do_handshake(ssl_);
+    if (ret == 1) {
+        handshake_done_ = true;
+        want_write_ = false;
+#ifdef SSL_OP_ENABLE_KTLS
+        kernel_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_));
+        kernel_receive_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_));
+#endif
+        context_->onHandshakeDone(resumed(), kernel_send_);
+        return 1;
+    }
+    int saved_errno = 0;
+    translateError(ret, &saved_errno);
+    return saved_errno == EAGAIN ? 0 : -1;
+}
+
+ssize_t TlsFilter::read(Buffer *buf, int *saved_errno) {
+    ssize_t total = 0;
+    while (true) {//读到SSL内部也没有缓存的记录为止，否则剩下的明文不会再触发可读事件
+        buf->ensureWritableBytes(16 * 1024);
+        size_t writable = std::min(buf->writeableBytes(), static_cast<size_t>(INT_MAX));
+        errno = 0;
+        int ret = SSL_read(ssl_, buf->beginWrite(), static_cast<int>(writable));
+        if (ret > 0) {
+            buf->hasWritten(static_cast<size_t>(ret));
+            total += ret;
+            continue;
+        }
+        ssize_t n = translateError(ret, saved_errno);
+        return total > 0 ? total : n;
+    }
+}
+
+ssize_t TlsFilter::write(const char *data, size_t len, int *saved_errno) {
+    if (len == 0) {
+        return 0;
+    }
+    errno = 0;
+    int ret = SSL_write(ssl_, data, static_cast<int>(std::min(len, static_cast<size_t>(INT_MAX))));
+    if (ret > 0) {
+        want_write_ = false;
+        return ret;
+    }
+    ssize_t n = translateError(ret, saved_errno);
+    if (n == 0) {//对端已发送close_notify
+        *saved_errno = EPIPE;
+        return -1;
+    }
+    return n;
+}
+
+void TlsFilter::shutdown() {
+    if (handshake_done_) {
+        SSL_shutdown(ssl_);
+        ERR_clear_error();
+    }
+}
+
+bool TlsFilter::resumed() const {
+    return SSL_session_reused(ssl_) == 1;
+}
+
+ssize_t TlsFilter::translateError(int ret, int *saved_errno) {
+    int err = SSL_get_error(ssl_, ret);
+    switch (err) {
+        case SSL_ERROR_WANT_READ:
+            want_write_ = false;
+            *saved_errno = EAGAIN;
+            return -1;
+        case SSL_ERROR_WANT_WRITE:
+            want_write_ = true;
+            *saved_errno = EAGAIN;
+            return -1;
+        case SSL_ERROR_ZERO_RETURN:
+            return 0;
+        case SSL_ERROR_SYSCALL:
+            ERR_clear_error();
+            if (errno == 0) {//没有close_notify的EOF
+                return 0;
+            }
+            *saved_errno = errno;
+            return -1;
+        default: {
+            char buf[256];
+            ERR_error_string_n(ERR_get_error(), buf, sizeof(buf));
+            ERR_clear_error();
+            LOG_ERROR << "TlsFilter:" << buf;
+            *saved_errno = EPROTO;
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "net/UdpServer.h"
+#include "net/EventLoop.h"
+#include <future>
+
+UdpServer::UdpServer(EventLoop *loop, const InetAddress &listen_addr, std::string name)
+    : loop_(loop), listen_addr_(listen_addr), name_(std::move(name)),
+      thread_pool_(new EventLoopThreadPool(loop, name_)),
+      max_datagram_size_(UdpSocket::DefaultMaxDatagramSize), gro_(false), gso_(false), started_(0) {}
+
+UdpServer::~UdpServer() {
+    for (auto &socket: sockets_) {//每个UdpSocket在自己的loop中销毁
+        EventLoop *io_loop = socket->getLoop();
+        if (io_loop->isInLoopThread()) {
+            socket.reset();
+        } else {
+            std::promise<void> done;
+            io_loop->runInLoop([&socket, &done] {
+                socket.reset();
+                done.set_value();
+            });
+            done.get_future().wait();
+        }
+    }
+}
+
+void UdpServer::setThreadNum(int num) {
+    thread_pool_->setThreadNum(num);
+}
+
+void UdpServer::setThreadAffinity(std::vector<CpuAffinity::CpuSet> cpu_sets) {
+    thread_pool_->setThreadAffinity(std::move(cpu_sets));
+}
+
+void UdpServer::start() {
+    if (started_++ == 0) {
+        thread_pool_->start(thread_init_callback_);
+        std::vector<EventLoop *> loops = thread_pool_->getAllLoops();
+        for (EventLoop *io_loop: loops) {
+            auto socket = std::make_unique<UdpSocket>(io_loop, listen_addr_, loops.size() > 1);
+            socket->setMessageCallback(message_callback_);
+            socket->setMaxDatagramSize(max_datagram_size_);
+            socket->enableGro(gro_);
+            socket->enableGso(gso_);
+            io_loop->runInLoop([socket = socket.get()] { socket->start(); });//接收缓冲分配在io线程中
+            sockets_.push_back(std::move(socket));
+        }
+    }
+}
+
+uint64_t UdpServer::receivedDatagrams() const {
+    uint64_t n = 0;
+    for (const auto &socket: sockets_) {
+        n += socket->receivedDatagrams();
+    }
+    return n;
+}
+
+uint64_t UdpServer::sentDatagrams() const {
+    uint64_t n = 0;
+    for (const auto &socket: sockets_) {
+        n += socket->sentDatagrams();
+    }
+    return n;
+}
+
+uint64_t UdpServer::droppedDatagrams() const {
+    uint64_t n = 0;
+    for (const auto &socket: sockets_) {
+        n += socket->droppedDatagrams();
+    }
+    return n;
+}
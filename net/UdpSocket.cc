@@ -0,0 +1,276 @@
+#include "net/UdpSocket.h"
+#include "base/FlightRecorder.h"
+#include "base/Logging.h"
+#include "net/EventLoop.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+
+namespace {
+    constexpr size_t MaxUdpPayload = 65507;
+    constexpr size_t MaxGsoSegments = 64;//UDP_MAX_SEGMENTS
+    constexpr size_t ControlSize = CMSG_SPACE(sizeof(int));
+
+    bool samePeer(const sockaddr_in &a, const sockaddr_in &b) {
+        return a.sin_port == b.sin_port && a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_family == b.sin_family;
+    }
+}// namespace
+
+UdpSocket::UdpSocket(EventLoop *loop, const InetAddress &bind_addr, bool reuse_port)
+    : loop_(loop), socket_(SocketOps::createNonblockingUdpSocket(bind_addr.family())),
+      channel_(loop, socket_.getFd()), max_datagram_size_(DefaultMaxDatagramSize),
+      max_pending_bytes_(4 * 1024 * 1024), gro_(false), gso_(false), in_read_(false), flush_queued_(false),
+      self_(std::make_shared<UdpSocket *>(this)), slot_size_(0), received_(0), sent_(0), dropped_(0) {
+    socket_.setReuseAddr(true);
+    socket_.setReusePort(reuse_port);
+    socket_.bind(bind_addr);
+    channel_.setReadCallback([this](Timestamp receive_time) { handleRead(receive_time); });
+    channel_.setWriteCallback([this] { handleWrite(); });
+}
+
+UdpSocket::~UdpSocket() {
+    channel_.disableAll();
+    channel_.remove();
+}
+
+bool UdpSocket::enableGro(bool on) {
+#ifdef UDP_GRO
+    int optval = on ? 1 : 0;
+    if (setsockopt(socket_.getFd(), IPPROTO_UDP, UDP_GRO, &optval, static_cast<socklen_t>(sizeof(optval))) == 0) {
+        gro_ = on;
+        return true;
+    }
+    LOG_WARN << "UdpSocket::enableGro:" << strerror(errno);
+#endif
+    gro_ = false;
+    return !on;
+}
+
+bool UdpSocket::enableGso(bool on) {
+    gso_ = false;
+    if (!on) {
+        return true;
+    }
+#ifdef UDP_SEGMENT
+    int optval = 0;//只探测内核是否支持，段长随每条消息在cmsg中给出
+    if (setsockopt(socket_.getFd(), IPPROTO_UDP, UDP_SEGMENT, &optval, static_cast<socklen_t>(sizeof(optval))) == 0) {
+        gso_ = true;
+        return true;
+    }
+    LOG_WARN << "UdpSocket::enableGso:" << strerror(errno);
+#endif
+    return false;
+}
+
+void UdpSocket::start() {
+    //开启GRO时一个缓冲可能收到多个数据报，按最大的合并包分配
+    slot_size_ = gro_ ? GroBufferSize : max_datagram_size_;
+    recv_buffers_.reset(new char[slot_size_ * BatchSize]);
+    recv_controls_.reset(new char[ControlSize * BatchSize]);
+    recv_msgs_.assign(BatchSize, mmsghdr{});
+    recv_iovs_.resize(BatchSize);
+    recv_addrs_.resize(BatchSize);
+    for (int i = 0; i < BatchSize; ++i) {
+        recv_iovs_[i].iov_base = recv_buffers_.get() + slot_size_ * i;
+        recv_iovs_[i].iov_len = slot_size_;
+        msghdr &hdr = recv_msgs_[i].msg_hdr;
+        hdr.msg_name = &recv_addrs_[i];
+        hdr.msg_iov = &recv_iovs_[i];
+        hdr.msg_iovlen = 1;
+    }
+    channel_.enableReading();
+}
+
+InetAddress UdpSocket::localAddress() const {
+    return InetAddress(SocketOps::getLocalAddr(socket_.getFd()));
+}
+
+void UdpSocket::handleRead(Timestamp receive_time) {
+    for (int i = 0; i < BatchSize; ++i) {//recvmmsg会改写这些字段
+        msghdr &hdr = recv_msgs_[i].msg_hdr;
+        hdr.msg_namelen = sizeof(sockaddr_in);
+        hdr.msg_control = gro_ ? recv_controls_.get() + ControlSize * i : nullptr;
+        hdr.msg_controllen = gro_ ? ControlSize : 0;
+        hdr.msg_flags = 0;
+    }
+    int n = ::recvmmsg(socket_.getFd(), recv_msgs_.data(), BatchSize, 0, nullptr);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            LOG_ERROR << "UdpSocket::handleRead:" << strerror(errno);
+        }
+        return;
+    }
+    uint64_t datagrams = 0;
+    in_read_ = true;
+    for (int i = 0; i < n; ++i) {
+        const msghdr &hdr = recv_msgs_[i].msg_hdr;
+        size_t len = recv_msgs_[i].msg_len;
+        if (hdr.msg_flags & MSG_TRUNC) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        size_t segment = len;
+#ifdef UDP_GRO
+        if (gro_) {
+            for (cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(const_cast<msghdr *>(&hdr), cmsg)) {
+                if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int gso_size;
+                    memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                    segment = gso_size > 0 ? static_cast<size_t>(gso_size) : len;
+                }
+            }
+        }
+#endif
+        InetAddress peer(recv_addrs_[i]);
+        const char *data = recv_buffers_.get() + slot_size_ * i;
+        size_t offset = 0;
+        do {//长度为0的数据报也交给回调
+            size_t segment_len = std::min(segment, len - offset);
+            if (message_callback_) {
+                message_callback_(this, data + offset, segment_len, peer, receive_time);
+            }
+            offset += segment_len;
+            ++datagrams;
+        } while (offset < len);
+    }
+    in_read_ = false;
+    received_.fetch_add(datagrams, std::memory_order_relaxed);
+    FLIGHT_RECORD(Read, socket_.getFd(), static_cast<int64_t>(datagrams));
+    if (!pending_.empty()) {//回调中的回复与本批一起发出
+        flush();
+    }
+}
+
+void UdpSocket::send(const void *data, size_t len, const InetAddress &peer) {
+    if (len > MaxUdpPayload || send_buffer_.readableBytes() + len > max_pending_bytes_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Datagram datagram{len, {}};
+    memcpy(&datagram.peer, peer.getSockAddr(), sizeof(datagram.peer));
+    send_buffer_.append(static_cast<const char *>(data), len);
+    pending_.push_back(datagram);
+    if (!in_read_ && !flush_queued_ && !channel_.isWriting()) {
+        flush_queued_ = true;
+        loop_->queueInLoop([weak_self = std::weak_ptr<UdpSocket *>(self_)] {
+            if (std::shared_ptr<UdpSocket *> self = weak_self.lock()) {
+                (*self)->flush_queued_ = false;
+                (*self)->flush();
+            }
+        });
+    }
+}
+
+void UdpSocket::flush() {
+    if (channel_.isWriting()) {//等待可写时由handleWrite发送
+        return;
+    }
+    if (!sendBatch()) {
+        channel_.enableWriting();
+    }
+}
+
+void UdpSocket::handleWrite() {
+    if (sendBatch()) {
+        channel_.disableWriting();
+    }
+}
+
+size_t UdpSocket::gsoRun(size_t first, size_t *bytes) const {
+    const Datagram &head = pending_[first];
+    size_t segment = head.len;
+    size_t count = 1;
+    *bytes = segment;
+    if (segment == 0) {
+        return 1;
+    }
+    while (first + count < pending_.size() && count < MaxGsoSegments) {
+        const Datagram &next = pending_[first + count];
+        if (next.len == 0 || next.len > segment || !samePeer(next.peer, head.peer) ||
+            *bytes + next.len > MaxUdpPayload) {
+            break;
+        }
+        *bytes += next.len;
+        ++count;
+        if (next.len < segment) {//只有最后一段可以更短
+            break;
+        }
+    }
+    return count;
+}
+
+bool UdpSocket::sendBatch() {
+    mmsghdr msgs[BatchSize];
+    iovec iovs[BatchSize];
+    size_t segments[BatchSize];
+    alignas(cmsghdr) char controls[BatchSize][CMSG_SPACE(sizeof(uint16_t))];
+    bool writable = true;
+    size_t done = 0;
+    while (done < pending_.size()) {
+        int count = 0;
+        size_t index = done;
+        const char *p = send_buffer_.peek();
+        while (count < BatchSize && index < pending_.size()) {
+            size_t bytes = pending_[index].len;
+            size_t run = gso_ ? gsoRun(index, &bytes) : 1;
+            msghdr &hdr = msgs[count].msg_hdr;
+            hdr = msghdr{};
+            hdr.msg_name = &pending_[index].peer;
+            hdr.msg_namelen = sizeof(sockaddr_in);
+            iovs[count].iov_base = const_cast<char *>(p);
+            iovs[count].iov_len = bytes;
+            hdr.msg_iov = &iovs[count];
+            hdr.msg_iovlen = 1;
+#ifdef UDP_SEGMENT
+            if (run > 1) {
+                hdr.msg_control = controls[count];
+                hdr.msg_controllen = sizeof(controls[count]);
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = IPPROTO_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                auto segment = static_cast<uint16_t>(pending_[index].len);
+                memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+            }
+#endif
+            segments[count] = run;
+            p += bytes;
+            index += run;
+            ++count;
+        }
+        int n = ::sendmmsg(socket_.getFd(), msgs, static_cast<unsigned int>(count), 0);
+        if (n < 0) {
+            int saved_errno = errno;
+            if (saved_errno == EAGAIN || saved_errno == EWOULDBLOCK) {
+                writable = false;
+                break;
+            }
+            if (saved_errno == EINTR) {
+                continue;
+            }
+            if (saved_errno == EIO && gso_) {//网卡不支持校验和卸载时GSO发送失败，改为逐个发送
+                LOG_WARN << "UdpSocket::sendBatch: GSO not supported by device, disabled";
+                gso_ = false;
+                continue;
+            }
+            //只有第一条消息出错时才返回-1（EMSGSIZE、ECONNREFUSED等），丢弃它后继续
+            LOG_ERROR << "UdpSocket::sendBatch:" << strerror(saved_errno);
+            dropped_.fetch_add(segments[0], std::memory_order_relaxed);
+            send_buffer_.retrieve(iovs[0].iov_len);
+            done += segments[0];
+            continue;
+        }
+        uint64_t datagrams = 0;
+        for (int i = 0; i < n; ++i) {
+            datagrams += segments[i];
+            send_buffer_.retrieve(iovs[i].iov_len);
+        }
+        done += datagrams;
+        sent_.fetch_add(datagrams, std::memory_order_relaxed);
+        FLIGHT_RECORD(Write, socket_.getFd(), static_cast<int64_t>(datagrams));
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(done));
+    return writable;
+}
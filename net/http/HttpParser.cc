@@ -0,0 +1,283 @@
+#include "net/http/HttpParser.h"
+#include "net/Buffer.h"
+#include <cstring>
+#include <strings.h>
+
+namespace {
+    const size_t MaxChunkLine = 1024;
+
+    const char *findCRLF(const char *begin, const char *end) {
+        const char *p = begin;
+        while (p + 1 < end) {
+            p = static_cast<const char *>(memchr(p, '\r', static_cast<size_t>(end - p - 1)));
+            if (p == nullptr) {
+                return nullptr;
+            }
+            if (p[1] == '\n') {
+                return p;
+            }
+            ++p;
+        }
+        return nullptr;
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && ::strncasecmp(a.data(), b.data(), a.size()) == 0;
+    }
+
+    bool containsIgnoreCase(std::string_view haystack, std::string_view needle) {
+        for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+            if (::strncasecmp(haystack.data() + i, needle.data(), needle.size()) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view trim(const char *begin, const char *end) {
+        while (begin < end && (*begin == ' ' || *begin == '\t')) {
+            ++begin;
+        }
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) {
+            --end;
+        }
+        return {begin, static_cast<size_t>(end - begin)};
+    }
+
+    HttpRequest::Method toMethod(std::string_view m) {
+        switch (m.size()) {
+            case 3:
+                if (m == "GET") return HttpRequest::Get;
+                if (m == "PUT") return HttpRequest::Put;
+                break;
+            case 4:
+                if (m == "POST") return HttpRequest::Post;
+                if (m == "HEAD") return HttpRequest::Head;
+                break;
+            case 5:
+                if (m == "PATCH") return HttpRequest::Patch;
+                break;
+            case 6:
+                if (m == "DELETE") return HttpRequest::Delete;
+                break;
+            case 7:
+                if (m == "OPTIONS") return HttpRequest::Options;
+                break;
+            default:
+                break;
+        }
+        return HttpRequest::Invalid;
+    }
+}// namespace
+
+HttpParser::Result HttpParser::parse(Buffer *buf, HttpRequest *request) {
+    if (state_ == ExpectHeaders) {
+        while (scanned_ == 0 && buf->readableBytes() >= 2 && buf->peek()[0] == '\r' && buf->peek()[1] == '\n') {
+            buf->retrieve(2);//请求之间多余的空行
+        }
+        size_t readable = buf->readableBytes();
+        size_t from = scanned_ > 3 ? scanned_ - 3 : 0;//\r\n\r\n可能跨越两次读取
+        const char *begin = buf->beginRead();
+        const char *end = static_cast<const char *>(memmem(begin + from, readable - from, "\r\n\r\n", 4));
+        if (end == nullptr) {
+            scanned_ = readable;
+            return readable > max_header_size_ ? fail(431) : Incomplete;
+        }
+        header_size_ = static_cast<size_t>(end - begin) + 4;
+        if (header_size_ > max_header_size_) {
+            return fail(431);
+        }
+        Result result = parseHeaders(begin, header_size_, request);
+        if (result == Error) {
+            return result;
+        }
+        if (chunked_) {
+            state_ = ExpectChunkSize;
+            raw_pos_ = header_size_;
+            decoded_size_ = 0;
+        } else {
+            state_ = ExpectBody;
+        }
+    }
+    if (state_ == ExpectBody) {
+        if (buf->readableBytes() < header_size_ + content_length_) {
+            return Incomplete;
+        }
+        return complete(buf, request, content_length_, header_size_ + content_length_);
+    }
+    Result result = parseChunked(buf);
+    if (result != Complete) {
+        return result;
+    }
+    return complete(buf, request, decoded_size_, raw_pos_);
+}
+
+HttpParser::Result HttpParser::complete(Buffer *buf, HttpRequest *request, size_t body_size, size_t request_size) {
+    const char *begin = buf->beginRead();
+    if (request->method_string_.data() != begin) {//请求体分多次到达，Buffer可能已经移动，重新取请求头
+        parseHeaders(begin, header_size_, request);
+    }
+    request->body_ = std::string_view(begin + header_size_, body_size);
+    request_size_ = request_size;
+    return Complete;
+}
+
+HttpParser::Result HttpParser::parseChunked(Buffer *buf) {
+    while (true) {
+        char *begin = buf->beginRead();
+        const char *end = begin + buf->readableBytes();
+        const char *pos = begin + raw_pos_;
+        if (state_ == ExpectChunkSize || state_ == ExpectChunkTrailers) {
+            const char *crlf = findCRLF(pos, end);
+            if (crlf == nullptr) {
+                return static_cast<size_t>(end - pos) > MaxChunkLine ? fail(400) : Incomplete;
+            }
+            raw_pos_ = static_cast<size_t>(crlf + 2 - begin);
+            if (raw_pos_ - header_size_ - decoded_size_ > max_header_size_) {//块头、块尾和trailer的总字节数
+                return fail(413);
+            }
+            if (state_ == ExpectChunkTrailers) {
+                if (crlf == pos) {//空行，请求结束
+                    return Complete;
+                }
+                continue;
+            }
+            uint64_t size = 0;
+            const char *p = pos;
+            for (; p < crlf && *p != ';'; ++p) {//忽略chunk extension
+                int digit;
+                if (*p >= '0' && *p <= '9') {
+                    digit = *p - '0';
+                } else if (*p >= 'a' && *p <= 'f') {
+                    digit = *p - 'a' + 10;
+                } else if (*p >= 'A' && *p <= 'F') {
+                    digit = *p - 'A' + 10;
+                } else if (*p == ' ' || *p == '\t') {
+                    continue;
+                } else {
+                    return fail(400);
+                }
+                if (size > (max_body_size_ >> 4)) {
+                    return fail(413);
+                }
+                size = size * 16 + static_cast<uint64_t>(digit);
+            }
+            if (p == pos) {
+                return fail(400);
+            }
+            if (size == 0) {
+                state_ = ExpectChunkTrailers;
+                continue;
+            }
+            if (decoded_size_ + size > max_body_size_) {
+                return fail(413);
+            }
+            chunk_remaining_ = size;
+            state_ = ExpectChunkData;
+        }
+        //ExpectChunkData，已到达的部分前移到已拼接的请求体之后
+        pos = begin + raw_pos_;
+        size_t available = static_cast<size_t>(end - pos);
+        size_t n = chunk_remaining_ < available ? static_cast<size_t>(chunk_remaining_) : available;
+        memmove(begin + header_size_ + decoded_size_, pos, n);
+        decoded_size_ += n;
+        raw_pos_ += n;
+        chunk_remaining_ -= n;
+        if (chunk_remaining_ > 0) {
+            return Incomplete;
+        }
+        if (buf->readableBytes() < raw_pos_ + 2) {
+            return Incomplete;
+        }
+        if (begin[raw_pos_] != '\r' || begin[raw_pos_ + 1] != '\n') {
+            return fail(400);
+        }
+        raw_pos_ += 2;
+        state_ = ExpectChunkSize;
+    }
+}
+
+HttpParser::Result HttpParser::parseHeaders(const char *begin, size_t len, HttpRequest *request) {
+    const char *end = begin + len - 2;//最后一个\r\n之前
+    const char *line_end = findCRLF(begin, end + 2);
+    //请求行 METHOD SP target SP HTTP/1.x
+    const char *sp1 = static_cast<const char *>(memchr(begin, ' ', static_cast<size_t>(line_end - begin)));
+    if (sp1 == nullptr) {
+        return fail(400);
+    }
+    const char *sp2 = static_cast<const char *>(memchr(sp1 + 1, ' ', static_cast<size_t>(line_end - sp1 - 1)));
+    if (sp2 == nullptr || sp2 == sp1 + 1) {
+        return fail(400);
+    }
+    request->method_string_ = std::string_view(begin, static_cast<size_t>(sp1 - begin));
+    request->method_ = toMethod(request->method_string_);
+    if (request->method_ == HttpRequest::Invalid) {
+        return fail(501);
+    }
+    std::string_view target(sp1 + 1, static_cast<size_t>(sp2 - sp1 - 1));
+    size_t question = target.find('?');
+    request->path_ = target.substr(0, question);
+    request->query_ = question == std::string_view::npos ? std::string_view() : target.substr(question + 1);
+    std::string_view version(sp2 + 1, static_cast<size_t>(line_end - sp2 - 1));
+    if (version == "HTTP/1.1") {
+        request->version_ = HttpRequest::Http11;
+    } else if (version == "HTTP/1.0") {
+        request->version_ = HttpRequest::Http10;
+    } else {
+        return fail(505);
+    }
+
+    request->num_headers_ = 0;
+    bool has_content_length = false;
+    std::string_view connection;
+    content_length_ = 0;
+    chunked_ = false;
+    const char *p = line_end + 2;
+    while (p < end) {
+        line_end = findCRLF(p, end + 2);
+        const char *colon = static_cast<const char *>(memchr(p, ':', static_cast<size_t>(line_end - p)));
+        if (colon == nullptr || colon == p) {
+            return fail(400);
+        }
+        if (request->num_headers_ == HttpRequest::MaxHeaders) {
+            return fail(431);
+        }
+        HttpRequest::Header &header = request->headers_[request->num_headers_++];
+        header.name = std::string_view(p, static_cast<size_t>(colon - p));
+        header.value = trim(colon + 1, line_end);
+        if (equalsIgnoreCase(header.name, "Content-Length")) {
+            uint64_t length = 0;
+            if (header.value.empty()) {
+                return fail(400);
+            }
+            for (char c: header.value) {
+                if (c < '0' || c > '9') {
+                    return fail(400);
+                }
+                length = length * 10 + static_cast<uint64_t>(c - '0');
+                if (length > max_body_size_) {
+                    return fail(413);
+                }
+            }
+            if (has_content_length && length != content_length_) {
+                return fail(400);
+            }
+            has_content_length = true;
+            content_length_ = length;
+        } else if (equalsIgnoreCase(header.name, "Transfer-Encoding")) {
+            chunked_ = containsIgnoreCase(header.value, "chunked");
+        } else if (equalsIgnoreCase(header.name, "Connection")) {
+            connection = header.value;
+        }
+        p = line_end + 2;
+    }
+    if (chunked_ && has_content_length) {//两者同时出现可能是请求走私
+        return fail(400);
+    }
+    if (request->version_ == HttpRequest::Http11) {
+        request->keep_alive_ = !containsIgnoreCase(connection, "close");
+    } else {
+        request->keep_alive_ = containsIgnoreCase(connection, "keep-alive");
+    }
+    return Complete;
+}
@@ -0,0 +1,106 @@
+#include "net/http/HttpResponse.h"
+#include "net/Buffer.h"
+#include <cstdio>
+#include <ctime>
+
+namespace {
+    //本线程上次格式化的秒及 "Date: ...\r\n"
+    thread_local time_t t_date_second = 0;
+    thread_local char t_date[64];
+    thread_local size_t t_date_length = 0;
+
+    void appendDate(Buffer *output) {
+        time_t now = ::time(nullptr);
+        if (now != t_date_second) {
+            t_date_second = now;
+            tm tm_time{};
+            gmtime_r(&now, &tm_time);
+            t_date_length = strftime(t_date, sizeof(t_date), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm_time);
+        }
+        output->append(t_date, t_date_length);
+    }
+
+    void appendNumber(Buffer *output, size_t n) {
+        char buf[24];
+        char *p = buf + sizeof(buf);
+        do {
+            *--p = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n > 0);
+        output->append(p, static_cast<size_t>(buf + sizeof(buf) - p));
+    }
+}// namespace
+
+std::string_view HttpResponse::reasonPhrase(int code) {
+    switch (code) {
+        case 100:
+            return "Continue";
+        case 101:
+            return "Switching Protocols";
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 204:
+            return "No Content";
+        case 301:
+            return "Moved Permanently";
+        case 302:
+            return "Found";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 403:
+            return "Forbidden";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 413:
+            return "Payload Too Large";
+        case 426:
+            return "Upgrade Required";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        case 505:
+            return "HTTP Version Not Supported";
+        default:
+            return "Unknown";
+    }
+}
+
+void HttpResponse::appendToBuffer(Buffer *output, bool include_body) const {
+    std::string_view body = body_view_.empty() ? std::string_view(body_) : body_view_;
+    output->append("HTTP/1.1 ", 9);
+    appendNumber(output, static_cast<size_t>(status_code_));
+    output->append(" ", 1);
+    std::string_view reason = custom_reason_.empty() ? reason_ : std::string_view(custom_reason_);
+    output->append(reason.data(), reason.size());
+    if (status_code_ == 101) {//协议切换，之后的字节不再是HTTP
+        output->append("\r\nConnection: Upgrade\r\n", 23);
+        appendDate(output);
+        output->append(headers_.data(), headers_.size());
+        output->append("\r\n", 2);
+        return;
+    }
+    output->append("\r\nContent-Length: ", 18);
+    appendNumber(output, body.size());
+    if (close_connection_) {
+        output->append("\r\nConnection: close\r\n", 21);
+    } else {
+        output->append("\r\nConnection: keep-alive\r\n", 26);
+    }
+    appendDate(output);
+    output->append(headers_.data(), headers_.size());
+    output->append("\r\n", 2);
+    if (include_body) {
+        output->append(body.data(), body.size());
+    }
+}
@@ -0,0 +1,69 @@
+#include "net/http/HttpServer.h"
+#include "base/BinaryLogging.h"
+
+namespace {
+    void defaultHttpCallback(const HttpRequest &, HttpResponse *response) {
+        response->setStatus(404);
+        response->setCloseConnection(true);
+    }
+
+    //同一io线程中所有连接共用，每次使用前清空，send后数据已写出、拷入连接的输出缓冲或丢弃
+    thread_local Buffer t_output;
+}// namespace
+
+HttpServer::HttpServer(EventLoop *loop, const InetAddress &listen_addr, std::string name, TcpServer::Option option)
+    : server_(loop, listen_addr, std::move(name), option), http_callback_(defaultHttpCallback),
+      max_header_size_(8 * 1024), max_body_size_(1024 * 1024) {
+    server_.setConnectionCallback([this](const TcpConnectionPtr &conn) { onConnection(conn); });
+    server_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time) {
+        onMessage(conn, buf, receive_time);
+    });
+}
+
+void HttpServer::onConnection(const TcpConnectionPtr &conn) {
+    if (conn->connect()) {
+        conn->setContext(Session{HttpParser(max_header_size_, max_body_size_)});
+    }
+}
+
+void HttpServer::onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+    auto *session = std::any_cast<Session>(conn->getMutableContext());
+    if (session->closing) {//已半关闭，对端之后发来的请求不再处理
+        buf->retrieveAll();
+        return;
+    }
+    HttpParser *parser = &session->parser;
+    Buffer &output = t_output;
+    output.retrieveAll();//http_callback_抛出异常时可能留下半个响应
+    HttpRequest request;
+    bool close = false;
+    while (!close && buf->readableBytes() > 0) {
+        HttpParser::Result result = parser->parse(buf, &request);
+        if (result == HttpParser::Incomplete) {
+            break;
+        }
+        if (result == HttpParser::Error) {
+            LOG_BIN_DEBUG("HttpServer bad request on connection {} status {}", conn->id(), parser->errorStatus());
+            HttpResponse response(true);
+            response.setStatus(parser->errorStatus());
+            response.appendToBuffer(&output);
+            buf->retrieveAll();
+            close = true;
+            break;
+        }
+        HttpResponse response(!request.keepAlive());
+        http_callback_(request, &response);
+        response.appendToBuffer(&output, request.method() != HttpRequest::Head);
+        buf->retrieve(parser->requestSize());
+        parser->reset();
+        close = response.closeConnection();
+    }
+    if (output.readableBytes() > 0) {
+        conn->send(&output);
+    }
+    if (close) {
+        session->closing = true;
+        buf->retrieveAll();
+        conn->shutdown();
+    }
+}
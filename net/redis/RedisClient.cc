@@ -0,0 +1,132 @@
+#include "net/redis/RedisClient.h"
+#include "base/Logging.h"
+#include "net/EventLoop.h"
+#include <charconv>
+#include <string>
+
+namespace {
+    //连接断开时交给回调的Null回复，初始化后只读，各线程共用
+    struct NullReply {
+        Buffer buf;
+        RespParser parser;
+
+        NullReply() {
+            buf.append("_\r\n", 3);
+            parser.parse(&buf);
+        }
+    };
+
+    RespValue nullReply() {
+        static const NullReply instance;
+        return instance.parser.reply();
+    }
+}// namespace
+
+RedisClient::RedisClient(EventLoop *loop, const InetAddress &server_addr, const std::string &name)
+    : loop_(loop), client_(loop, server_addr, name), flush_queued_(false) {
+    client_.setConnectionCallback([this](const TcpConnectionPtr &conn) { onConnection(conn); });
+    client_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) { onMessage(conn, buf); });
+}
+
+void RedisClient::encodeCommand(Buffer *buf, const std::string_view *args, size_t count) {
+    char header[32];
+    header[0] = '*';
+    char *end = std::to_chars(header + 1, header + sizeof(header) - 2, count).ptr;
+    *end++ = '\r';
+    *end++ = '\n';
+    buf->append(header, static_cast<size_t>(end - header));
+    for (size_t i = 0; i < count; ++i) {
+        header[0] = '$';
+        end = std::to_chars(header + 1, header + sizeof(header) - 2, args[i].size()).ptr;
+        *end++ = '\r';
+        *end++ = '\n';
+        buf->ensureWritableBytes(static_cast<size_t>(end - header) + args[i].size() + 2);
+        buf->append(header, static_cast<size_t>(end - header));
+        buf->append(args[i].data(), args[i].size());
+        buf->append(CRLF, 2);
+    }
+}
+
+void RedisClient::command(const std::string_view *args, size_t count, ReplyCallback cb) {
+    if (loop_->isInLoopThread()) {
+        commandInLoop(args, count, std::move(cb));
+        return;
+    }
+    std::vector<std::string> copies(args, args + count);
+    loop_->queueInLoop([this, copies = std::move(copies), cb = std::move(cb)]() mutable {
+        std::vector<std::string_view> views(copies.begin(), copies.end());
+        commandInLoop(views.data(), views.size(), std::move(cb));
+    });
+}
+
+void RedisClient::commandInLoop(const std::string_view *args, size_t count, ReplyCallback cb) {
+    encodeCommand(&output_, args, count);
+    callbacks_.push_back(std::move(cb));
+    if (!flush_queued_ && conn_) {//排在本轮已就绪的事件之后，同一轮的命令合并发送
+        flush_queued_ = true;
+        loop_->queueInLoop([this] { flush(); });
+    }
+}
+
+void RedisClient::flush() {
+    flush_queued_ = false;
+    if (conn_ && output_.readableBytes() > 0) {
+        conn_->send(&output_);
+    }
+}
+
+void RedisClient::onConnection(const TcpConnectionPtr &conn) {
+    if (conn->connect()) {
+        conn_ = conn;
+        flush();
+    } else {
+        conn_.reset();
+        output_.retrieveAll();
+        parser_.reset();
+        std::deque<ReplyCallback> callbacks;
+        callbacks.swap(callbacks_);//回调中可能再次发命令
+        for (ReplyCallback &cb: callbacks) {
+            if (cb) {
+                cb(Disconnected, nullReply());
+            }
+        }
+    }
+    if (connection_callback_) {
+        connection_callback_(conn);
+    }
+}
+
+void RedisClient::onMessage(const TcpConnectionPtr &conn, Buffer *buf) {
+    while (buf->readableBytes() > 0) {
+        RespParser::Result result = parser_.parse(buf);
+        if (result == RespParser::Incomplete) {
+            break;
+        }
+        if (result == RespParser::Error) {
+            LOG_ERROR << "RedisClient::onMessage [" << client_.name() << "] - protocol error";
+            buf->retrieveAll();
+            parser_.reset();
+            conn->forceClose();
+            break;
+        }
+        RespValue reply = parser_.reply();
+        if (reply.type() == RespValue::Push) {
+            if (push_callback_) {
+                push_callback_(reply);
+            }
+        } else if (callbacks_.empty()) {
+            LOG_ERROR << "RedisClient::onMessage [" << client_.name() << "] - unexpected reply";
+        } else {
+            ReplyCallback cb = std::move(callbacks_.front());
+            callbacks_.pop_front();
+            if (cb) {
+                cb(Ok, reply);
+            }
+        }
+        if (conn_ != conn) {//回调中关闭了连接，未回复的命令已经结束
+            break;
+        }
+        buf->retrieve(parser_.replySize());
+        parser_.reset();
+    }
+}
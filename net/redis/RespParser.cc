@@ -0,0 +1,201 @@
+#include "net/redis/RespParser.h"
+#include "net/Buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+    bool parseInteger(std::string_view str, int64_t *value) {
+        if (str.empty() || str.size() > 20) {
+            return false;
+        }
+        size_t i = 0;
+        bool negative = str[0] == '-';
+        if (negative || str[0] == '+') {
+            i = 1;
+        }
+        if (i == str.size()) {
+            return false;
+        }
+        uint64_t v = 0;
+        for (; i < str.size(); ++i) {
+            if (str[i] < '0' || str[i] > '9') {
+                return false;
+            }
+            v = v * 10 + static_cast<uint64_t>(str[i] - '0');
+        }
+        *value = negative ? static_cast<int64_t>(0 - v) : static_cast<int64_t>(v);
+        return true;
+    }
+}// namespace
+
+RespValue::Type RespValue::type() const {
+    return parser_->nodes_[index_].type;
+}
+
+bool RespValue::isNull() const {
+    return parser_->nodes_[index_].null;
+}
+
+std::string_view RespValue::str() const {
+    const RespParser::Node &node = parser_->nodes_[index_];
+    return std::string_view(parser_->base_ + node.offset, node.length);
+}
+
+int64_t RespValue::integer() const {
+    return parser_->nodes_[index_].integer;
+}
+
+double RespValue::toDouble() const {
+    std::string text(str());
+    if (text == "inf") {
+        return HUGE_VAL;
+    }
+    if (text == "-inf") {
+        return -HUGE_VAL;
+    }
+    return std::strtod(text.c_str(), nullptr);
+}
+
+size_t RespValue::size() const {
+    return parser_->nodes_[index_].elements;
+}
+
+RespValue RespValue::operator[](size_t i) const {
+    const std::vector<RespParser::Node> &nodes = parser_->nodes_;
+    size_t index = index_ + 1;
+    size_t n = 0;
+    while (true) {
+        if (nodes[index].type == Attribute) {
+            index += nodes[index].span;
+            continue;
+        }
+        if (n == i) {
+            return RespValue(parser_, index);
+        }
+        index += nodes[index].span;
+        ++n;
+    }
+}
+
+RespParser::Result RespParser::parse(Buffer *buf) {
+    const char *begin = buf->peek();
+    size_t readable = buf->readableBytes();
+    while (pos_ < readable) {
+        const char *line = begin + pos_;
+        size_t available = readable - pos_;
+        const auto *lf = static_cast<const char *>(memchr(line, '\n', std::min(available, MaxLineSize)));
+        if (lf == nullptr) {
+            return available < MaxLineSize ? Incomplete : Error;
+        }
+        if (lf - line < 2 || lf[-1] != '\r') {
+            return Error;
+        }
+        std::string_view arg(line + 1, static_cast<size_t>(lf - line - 2));
+        size_t next = static_cast<size_t>(lf + 1 - begin);
+        Node node{};
+        node.type = static_cast<RespValue::Type>(*line);
+        node.span = 1;
+        size_t children = 0;
+        switch (*line) {
+            case RespValue::SimpleString:
+            case RespValue::Error:
+            case RespValue::Double:
+            case RespValue::BigNumber:
+                node.offset = pos_ + 1;
+                node.length = arg.size();
+                break;
+            case RespValue::Integer:
+                if (!parseInteger(arg, &node.integer)) {
+                    return Error;
+                }
+                break;
+            case RespValue::Null:
+                node.null = true;
+                break;
+            case RespValue::Boolean:
+                if (arg != "t" && arg != "f") {
+                    return Error;
+                }
+                node.integer = arg == "t";
+                break;
+            case RespValue::BulkString:
+            case RespValue::BulkError:
+            case RespValue::VerbatimString: {
+                int64_t len;
+                if (!parseInteger(arg, &len) || len < -1 || len > static_cast<int64_t>(max_bulk_size_)) {
+                    return Error;
+                }
+                if (len == -1) {//RESP2的空值
+                    node.null = true;
+                    break;
+                }
+                auto size = static_cast<size_t>(len);
+                if (readable - next < size + 2) {//等数据到齐后重新解析这一行
+                    return Incomplete;
+                }
+                if (begin[next + size] != '\r' || begin[next + size + 1] != '\n') {
+                    return Error;
+                }
+                node.offset = next;
+                node.length = size;
+                next += size + 2;
+                break;
+            }
+            case RespValue::Array:
+            case RespValue::Set:
+            case RespValue::Push:
+            case RespValue::Map:
+            case RespValue::Attribute: {
+                int64_t count;
+                if (!parseInteger(arg, &count) || count < -1 || count > static_cast<int64_t>(max_elements_)) {
+                    return Error;
+                }
+                if (count == -1) {
+                    node.null = true;
+                    break;
+                }
+                children = static_cast<size_t>(count);
+                if (*line == RespValue::Map || *line == RespValue::Attribute) {
+                    children *= 2;
+                }
+                node.elements = static_cast<uint32_t>(children);
+                break;
+            }
+            default:
+                return Error;
+        }
+        pos_ = next;
+        size_t done = nodes_.size();
+        nodes_.push_back(node);
+        if (children > 0) {
+            if (stack_.size() == MaxDepth) {
+                return Error;
+            }
+            stack_.push_back({done, children});
+            continue;
+        }
+        while (true) {//向上结束已收齐元素的聚合
+            nodes_[done].span = static_cast<uint32_t>(nodes_.size() - done);
+            if (stack_.empty()) {
+                if (nodes_[done].type == RespValue::Attribute) {//属性之后才是真正的回复
+                    break;
+                }
+                root_ = done;
+                base_ = begin;
+                return Complete;
+            }
+            if (nodes_[done].type != RespValue::Attribute) {
+                --stack_.back().remaining;
+            }
+            if (stack_.back().remaining > 0) {
+                break;
+            }
+            done = stack_.back().node;
+            stack_.pop_back();
+        }
+    }
+    return Incomplete;
+}
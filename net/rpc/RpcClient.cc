@@ -0,0 +1,97 @@
+#include "net/rpc/RpcClient.h"
+#include "base/BinaryLogging.h"
+#include "net/EventLoop.h"
+#include <string>
+
+RpcClient::RpcClient(EventLoop *loop, const InetAddress &server_addr, const std::string &name)
+    : loop_(loop), client_(loop, server_addr, name),
+      codec_([this](const TcpConnectionPtr &conn, std::string_view frame, Timestamp) { onFrame(conn, frame); }),
+      next_id_(1), flush_queued_(false) {
+    client_.setConnectionCallback([this](const TcpConnectionPtr &conn) { onConnection(conn); });
+    client_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time) {
+        codec_.onMessage(conn, buf, receive_time);
+    });
+}
+
+void RpcClient::call(std::string_view method, std::string_view payload, ResponseCallback cb, double timeout) {
+    if (loop_->isInLoopThread()) {
+        callInLoop(method, payload, std::move(cb), timeout);
+    } else {
+        loop_->queueInLoop([this, method = std::string(method), payload = std::string(payload),
+                            cb = std::move(cb), timeout]() mutable {
+            callInLoop(method, payload, std::move(cb), timeout);
+        });
+    }
+}
+
+void RpcClient::callInLoop(std::string_view method, std::string_view payload, ResponseCallback cb, double timeout) {
+    uint64_t id = next_id_++;
+    Call &call = pending_[id];
+    call.callback = std::move(cb);
+    call.has_timer = timeout > 0;
+    if (call.has_timer) {
+        call.timer = loop_->runAfter(timeout, [this, id] { onTimeout(id); });
+    }
+    RpcMessage::encode(&output_, id, RpcMessage::Request, method, payload);
+    if (!flush_queued_ && conn_) {//排在本轮已就绪的事件之后，同一轮的请求合并发送
+        flush_queued_ = true;
+        loop_->queueInLoop([this] { flush(); });
+    }
+}
+
+void RpcClient::flush() {
+    flush_queued_ = false;
+    if (conn_ && output_.readableBytes() > 0) {
+        conn_->send(&output_);
+    }
+}
+
+void RpcClient::onConnection(const TcpConnectionPtr &conn) {
+    if (conn->connect()) {
+        conn_ = conn;
+        flush();
+    } else {
+        conn_.reset();
+        output_.retrieveAll();
+        std::unordered_map<uint64_t, Call> calls;
+        calls.swap(pending_);//回调中可能再次call
+        for (auto &item: calls) {
+            if (item.second.has_timer) {
+                loop_->cancel(item.second.timer);
+            }
+            item.second.callback(Disconnected, std::string_view());
+        }
+    }
+    if (connection_callback_) {
+        connection_callback_(conn);
+    }
+}
+
+void RpcClient::onFrame(const TcpConnectionPtr &conn, std::string_view frame) {
+    RpcMessage response;
+    if (!RpcMessage::decode(frame, &response) || response.kind == RpcMessage::Request) {
+        LOG_BIN_ERROR("RpcClient bad response frame on {}", client_.name());
+        conn->forceClose();
+        return;
+    }
+    auto it = pending_.find(response.id);
+    if (it == pending_.end()) {//已超时
+        return;
+    }
+    Call call = std::move(it->second);
+    pending_.erase(it);
+    if (call.has_timer) {
+        loop_->cancel(call.timer);
+    }
+    call.callback(response.kind == RpcMessage::Response ? Ok : Error, response.payload);
+}
+
+void RpcClient::onTimeout(uint64_t id) {
+    auto it = pending_.find(id);
+    if (it == pending_.end()) {
+        return;
+    }
+    Call call = std::move(it->second);
+    pending_.erase(it);
+    call.callback(Timeout, std::string_view());
+}
@@ -0,0 +1,38 @@
+#include "net/rpc/RpcMessage.h"
+#include "net/Buffer.h"
+#include "net/LengthHeaderCodec.h"
+
+void RpcMessage::encode(Buffer *buf, uint64_t id, Kind kind, std::string_view method, std::string_view payload) {
+    if (method.size() > UINT16_MAX) {
+        method = method.substr(0, UINT16_MAX);
+    }
+    size_t len = HeaderLen + method.size() + payload.size();
+    buf->ensureWritableBytes(LengthHeaderCodec::HeaderLen + len);
+    buf->appendInt32(static_cast<int32_t>(len));
+    buf->appendInt64(static_cast<int64_t>(id));
+    buf->appendInt8(static_cast<int8_t>(kind));
+    buf->appendInt16(static_cast<int16_t>(method.size()));
+    buf->append(method.data(), method.size());
+    buf->append(payload.data(), payload.size());
+}
+
+bool RpcMessage::decode(std::string_view frame, RpcMessage *message) {
+    if (frame.size() < HeaderLen) {
+        return false;
+    }
+    const auto *p = reinterpret_cast<const unsigned char *>(frame.data());
+    uint64_t id = 0;
+    for (int i = 0; i < 8; ++i) {
+        id = (id << 8) | p[i];
+    }
+    auto kind = static_cast<Kind>(p[8]);
+    size_t method_len = (static_cast<size_t>(p[9]) << 8) | p[10];
+    if (kind > Error || frame.size() < HeaderLen + method_len) {
+        return false;
+    }
+    message->id = id;
+    message->kind = kind;
+    message->method = frame.substr(HeaderLen, method_len);
+    message->payload = frame.substr(HeaderLen + method_len);
+    return true;
+}
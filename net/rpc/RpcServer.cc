@@ -0,0 +1,65 @@
+#include "net/rpc/RpcServer.h"
+#include "base/BinaryLogging.h"
+
+namespace {
+    //onMessage期间同步回复的响应追加到t_batch，结束时一次send
+    //同一线程的所有连接共用，每次send后清空：连接已关闭时数据不会写出，也不能留给下一个连接
+    thread_local TcpConnection *t_batch_conn = nullptr;
+    thread_local Buffer t_batch;
+    thread_local Buffer t_output;
+}// namespace
+
+void RpcServer::Responder::send(RpcMessage::Kind kind, std::string_view payload) const {
+    TcpConnectionPtr conn = conn_.lock();
+    if (!conn) {
+        return;
+    }
+    if (conn.get() == t_batch_conn) {
+        RpcMessage::encode(&t_batch, id_, kind, std::string_view(), payload);
+        return;
+    }
+    Buffer &output = t_output;
+    RpcMessage::encode(&output, id_, kind, std::string_view(), payload);
+    conn->send(&output);
+    output.retrieveAll();
+}
+
+RpcServer::RpcServer(EventLoop *loop, const InetAddress &listen_addr, std::string name, TcpServer::Option option)
+    : server_(loop, listen_addr, std::move(name), option) {
+    setMaxFrameSize(LengthHeaderCodec::DefaultMaxFrameSize);
+    server_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time) {
+        onMessage(conn, buf, receive_time);
+    });
+}
+
+void RpcServer::setMaxFrameSize(size_t size) {
+    codec_ = std::make_unique<LengthHeaderCodec>(
+            [this](const TcpConnectionPtr &conn, std::string_view frame, Timestamp) { onFrame(conn, frame); }, size);
+}
+
+void RpcServer::onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receive_time) {
+    t_batch.retrieveAll();//方法回调抛出异常时可能留下上一批
+    t_batch_conn = conn.get();
+    codec_->onMessage(conn, buf, receive_time);
+    t_batch_conn = nullptr;
+    if (t_batch.readableBytes() > 0) {//请求后跟着错误帧时连接已forceClose，这批回复被丢弃
+        conn->send(&t_batch);
+    }
+    t_batch.retrieveAll();
+}
+
+void RpcServer::onFrame(const TcpConnectionPtr &conn, std::string_view frame) {
+    RpcMessage request;
+    if (!RpcMessage::decode(frame, &request) || request.kind != RpcMessage::Request) {
+        LOG_BIN_ERROR("RpcServer bad request frame on connection {}", conn->id());
+        conn->forceClose();
+        return;
+    }
+    Responder responder(conn, request.id);
+    auto it = methods_.find(request.method);
+    if (it == methods_.end()) {
+        responder.fail("unknown method");
+        return;
+    }
+    it->second(conn, request.payload, responder);
+}
@@ -0,0 +1,178 @@
+#include "net/websocket/WebSocketCodec.h"
+#include "net/Buffer.h"
+#include <cstring>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void WebSocketCodec::mask(char *data, size_t len, const uint8_t *mask_key) {
+    size_t i = 0;
+#ifdef __SSE2__
+    int32_t key32;
+    memcpy(&key32, mask_key, 4);
+    const __m128i key128 = _mm_set1_epi32(key32);//按内存顺序重复mask_key
+    for (; i + 16 <= len; i += 16) {
+        auto *p = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key128));
+    }
+#endif
+    uint64_t key64;
+    memcpy(&key64, mask_key, 4);
+    memcpy(reinterpret_cast<char *>(&key64) + 4, mask_key, 4);
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, 8);
+        v ^= key64;
+        memcpy(data + i, &v, 8);
+    }
+    for (; i < len; ++i) {//前面每次处理8或16字节，i & 3就是掩码相位
+        data[i] = static_cast<char>(data[i] ^ mask_key[i & 3]);
+    }
+}
+
+WebSocketCodec::Result WebSocketCodec::parse(Buffer *buf) {
+    char *begin = buf->beginRead();
+    size_t readable = buf->readableBytes();
+    while (true) {
+        if (readable - scan_ < 2) {
+            return last_ = Incomplete;
+        }
+        const auto *p = reinterpret_cast<const uint8_t *>(begin + scan_);
+        bool fin = (p[0] & 0x80) != 0;
+        auto opcode = static_cast<Opcode>(p[0] & 0x0F);
+        bool masked = (p[1] & 0x80) != 0;
+        if ((p[0] & 0x70) != 0 || masked != expect_masked_) {//未协商扩展，RSV必须为0
+            return last_ = fail(ProtocolError);
+        }
+        size_t header_len = 2 + (masked ? 4 : 0);
+        uint64_t len = p[1] & 0x7F;
+        if (len == 126) {
+            header_len += 2;
+        } else if (len == 127) {
+            header_len += 8;
+        }
+        if (readable - scan_ < header_len) {
+            return last_ = Incomplete;
+        }
+        if (len == 126) {
+            len = static_cast<uint64_t>(p[2]) << 8 | p[3];
+        } else if (len == 127) {
+            len = 0;
+            for (int i = 0; i < 8; ++i) {
+                len = len << 8 | p[2 + i];
+            }
+        }
+        bool control = (opcode & 0x8) != 0;
+        if (control) {
+            if (!fin || len > 125 || (opcode != Close && opcode != Ping && opcode != Pong)) {
+                return last_ = fail(ProtocolError);
+            }
+        } else {
+            if (opcode > Binary || (opcode == Continuation) != in_message_) {
+                return last_ = fail(ProtocolError);
+            }
+            if (len > max_message_size_ - message_len_) {
+                return last_ = fail(MessageTooBig);
+            }
+        }
+        if (readable - scan_ - header_len < len) {
+            return last_ = Incomplete;
+        }
+        char *payload = begin + scan_ + header_len;
+        if (masked) {
+            mask(payload, len, p + header_len - 4);
+        }
+        if (control) {
+            frame_end_ = scan_ + header_len + len;
+            opcode_ = opcode;
+            payload_ = std::string_view(payload, len);
+            return last_ = Control;
+        }
+        if (!in_message_) {
+            in_message_ = true;
+            message_opcode_ = opcode;
+            message_begin_ = scan_ + header_len;
+            message_len_ = 0;
+        }
+        char *message_end = begin + message_begin_ + message_len_;
+        if (message_end != payload) {//后续分片拼接到前面的负载之后
+            memmove(message_end, payload, len);
+        }
+        message_len_ += len;
+        scan_ += header_len + len;
+        if (fin) {
+            opcode_ = message_opcode_;
+            payload_ = std::string_view(begin + message_begin_, message_len_);
+            return last_ = Message;
+        }
+    }
+}
+
+void WebSocketCodec::consume(Buffer *buf) {
+    if (last_ == Message) {
+        buf->retrieve(scan_);
+        scan_ = 0;
+        in_message_ = false;
+        message_len_ = 0;
+    } else if (last_ == Control) {
+        if (in_message_) {//控制帧留在已拼接的负载之后，会被后续分片覆盖
+            scan_ = frame_end_;
+        } else {
+            buf->retrieve(frame_end_);
+            scan_ = 0;
+        }
+    }
+    last_ = Incomplete;
+    payload_ = std::string_view();
+}
+
+size_t WebSocketCodec::writeHeader(uint8_t *header, Opcode opcode, bool fin, size_t len, const uint8_t *mask_key) {
+    size_t n = 0;
+    header[n++] = static_cast<uint8_t>((fin ? 0x80 : 0) | opcode);
+    uint8_t mask_bit = mask_key ? 0x80 : 0;
+    if (len < 126) {
+        header[n++] = static_cast<uint8_t>(mask_bit | len);
+    } else if (len <= 0xFFFF) {
+        header[n++] = static_cast<uint8_t>(mask_bit | 126);
+        header[n++] = static_cast<uint8_t>(len >> 8);
+        header[n++] = static_cast<uint8_t>(len);
+    } else {
+        header[n++] = static_cast<uint8_t>(mask_bit | 127);
+        for (int i = 7; i >= 0; --i) {
+            header[n++] = static_cast<uint8_t>(static_cast<uint64_t>(len) >> (8 * i));
+        }
+    }
+    if (mask_key) {
+        memcpy(header + n, mask_key, 4);
+        n += 4;
+    }
+    return n;
+}
+
+void WebSocketCodec::encode(Buffer *buf, Opcode opcode, bool fin, const uint8_t *mask_key) {
+    size_t len = buf->readableBytes();
+    uint8_t header[MaxHeaderLen];
+    size_t header_len = writeHeader(header, opcode, fin, len, mask_key);
+    if (buf->prependableBytes() < header_len) {//预留区已被占用时才复制，retrieveAll后预留区恢复
+        std::string body = buf->retrieveAllAsString();
+        buf->append(body);
+    }
+    if (mask_key) {
+        mask(buf->beginRead(), len, mask_key);
+    }
+    buf->prepend(header, header_len);
+}
+
+void WebSocketCodec::appendFrame(Buffer *buf, Opcode opcode, std::string_view payload, const uint8_t *mask_key) {
+    uint8_t header[MaxHeaderLen];
+    size_t header_len = writeHeader(header, opcode, true, payload.size(), mask_key);
+    buf->ensureWritableBytes(header_len + payload.size());
+    buf->append(header, header_len);
+    char *data = buf->beginWrite();
+    buf->append(payload.data(), payload.size());
+    if (mask_key) {
+        mask(data, payload.size(), mask_key);
+    }
+}
@@ -0,0 +1,258 @@
+#include "net/websocket/WebSocketServer.h"
+#include "base/Base64.h"
+#include "base/BinaryLogging.h"
+#include "base/Sha1.h"
+#include "net/EventLoop.h"
+#include "net/http/HttpParser.h"
+#include "net/http/HttpResponse.h"
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+
+struct WebSocketServer::Session {
+    explicit Session(size_t max_message_size) : websocket(true, max_message_size) {}
+
+    State state = Handshake;
+    HttpParser http;
+    WebSocketCodec websocket;
+    LoopConnections *loop_connections = nullptr;
+};
+
+namespace {
+    constexpr char AcceptGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    //同一线程的所有连接共用，每次send后清空：连接已shutdown时数据不会写出，也不能留给下一个连接
+    thread_local Buffer t_output;
+
+    //逗号分隔的列表中是否有token，不区分大小写
+    bool hasToken(std::string_view list, std::string_view token) {
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            std::string_view item = list.substr(0, comma);
+            while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) {
+                item.remove_prefix(1);
+            }
+            while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) {
+                item.remove_suffix(1);
+            }
+            if (item.size() == token.size() && strncasecmp(item.data(), token.data(), token.size()) == 0) {
+                return true;
+            }
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            list.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+
+    void sendInLoop(const TcpConnectionPtr &conn, WebSocketCodec::Opcode opcode, std::string_view payload) {
+        Buffer &output = t_output;
+        WebSocketCodec::appendFrame(&output, opcode, payload);
+        conn->send(&output);
+        output.retrieveAll();
+    }
+
+    void sendClose(const TcpConnectionPtr &conn, uint16_t code, std::string_view reason) {
+        char payload[125];
+        payload[0] = static_cast<char>(code >> 8);
+        payload[1] = static_cast<char>(code);
+        size_t len = std::min(reason.size(), sizeof(payload) - 2);
+        memcpy(payload + 2, reason.data(), len);
+        sendInLoop(conn, WebSocketCodec::Close, std::string_view(payload, len + 2));
+    }
+}// namespace
+
+WebSocketServer::WebSocketServer(EventLoop *loop, const InetAddress &listen_addr, std::string name,
+                                 TcpServer::Option option)
+    : server_(loop, listen_addr, std::move(name), option), max_message_size_(16 * 1024 * 1024) {
+    server_.setConnectionCallback([this](const TcpConnectionPtr &conn) { onConnection(conn); });
+    server_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp) { onMessage(conn, buf); });
+}
+
+void WebSocketServer::onConnection(const TcpConnectionPtr &conn) {
+    if (conn->connect()) {
+        conn->setContext(Session(max_message_size_));
+        return;
+    }
+    auto *session = std::any_cast<Session>(conn->getMutableContext());
+    if (session != nullptr && session->loop_connections != nullptr) {
+        session->loop_connections->connections.erase(conn->id());
+        session->loop_connections->size.fetch_sub(1, std::memory_order_relaxed);
+        session->loop_connections = nullptr;
+        session->state = Closed;
+        if (close_callback_) {
+            close_callback_(conn);
+        }
+    }
+}
+
+void WebSocketServer::onMessage(const TcpConnectionPtr &conn, Buffer *buf) {
+    auto *session = std::any_cast<Session>(conn->getMutableContext());
+    if (session->state == Handshake && !handshake(conn, session, buf)) {
+        return;
+    }
+    onFrames(conn, session, buf);
+}
+
+bool WebSocketServer::handshake(const TcpConnectionPtr &conn, Session *session, Buffer *buf) {
+    HttpRequest request;
+    HttpParser::Result result = session->http.parse(buf, &request);
+    if (result == HttpParser::Incomplete) {
+        return false;
+    }
+    HttpResponse response(true);
+    std::string_view key = request.getHeader("Sec-WebSocket-Key");
+    std::string decoded_key;
+    if (result == HttpParser::Error) {
+        response.setStatus(session->http.errorStatus());
+    } else if (request.method() != HttpRequest::Get || request.version() != HttpRequest::Http11 ||
+               !hasToken(request.getHeader("Upgrade"), "websocket") ||
+               !hasToken(request.getHeader("Connection"), "upgrade") ||
+               !Base64::decode(key, &decoded_key) || decoded_key.size() != 16) {
+        response.setStatus(400);
+    } else if (request.getHeader("Sec-WebSocket-Version") != "13") {
+        response.setStatus(426);
+        response.addHeader("Sec-WebSocket-Version", "13");
+    } else if (accept_callback_ && !accept_callback_(request)) {
+        response.setStatus(403);
+    } else {
+        std::string accept_key(key);
+        accept_key += AcceptGuid;
+        Sha1::Digest digest = Sha1::digest(accept_key);
+        response.setStatus(101);
+        response.addHeader("Upgrade", "websocket");
+        response.addHeader("Sec-WebSocket-Accept",
+                           Base64::encode(std::string_view(reinterpret_cast<const char *>(digest.data()), digest.size())));
+    }
+    Buffer &output = t_output;
+    response.appendToBuffer(&output);
+    conn->send(&output);
+    output.retrieveAll();
+    if (response.statusCode() != 101) {
+        LOG_BIN_DEBUG("WebSocketServer handshake rejected on connection {} status {}", conn->id(), response.statusCode());
+        buf->retrieveAll();
+        conn->shutdown();
+        return false;
+    }
+    buf->retrieve(session->http.requestSize());
+    session->state = Open;
+    session->loop_connections = loopConnections(conn->getLoop());
+    session->loop_connections->connections[conn->id()] = conn;
+    session->loop_connections->size.fetch_add(1, std::memory_order_relaxed);
+    if (open_callback_) {
+        open_callback_(conn);
+    }
+    return true;
+}
+
+void WebSocketServer::onFrames(const TcpConnectionPtr &conn, Session *session, Buffer *buf) {
+    WebSocketCodec &codec = session->websocket;
+    while (session->state == Open || session->state == Closing) {
+        WebSocketCodec::Result result = codec.parse(buf);
+        if (result == WebSocketCodec::Incomplete) {
+            break;
+        }
+        if (result == WebSocketCodec::Error) {
+            LOG_BIN_DEBUG("WebSocketServer protocol error on connection {} code {}", conn->id(), codec.errorCode());
+            sendClose(conn, codec.errorCode(), {});
+            buf->retrieveAll();
+            session->state = Closed;
+            conn->shutdown();
+            break;
+        }
+        if (result == WebSocketCodec::Message) {
+            if (message_callback_ && session->state == Open) {
+                message_callback_(conn, codec.payload(), codec.opcode());
+            }
+        } else if (codec.opcode() == WebSocketCodec::Ping) {
+            sendInLoop(conn, WebSocketCodec::Pong, codec.payload());
+        } else if (codec.opcode() == WebSocketCodec::Close) {
+            if (session->state == Open) {//回显对端的关闭码
+                sendInLoop(conn, WebSocketCodec::Close, codec.payload().substr(0, 2));
+                conn->shutdown();
+            } else {
+                conn->forceClose();
+            }
+            session->state = Closed;
+        }
+        codec.consume(buf);
+    }
+    if (session->state == Closed) {
+        buf->retrieveAll();
+    }
+}
+
+WebSocketServer::LoopConnections *WebSocketServer::loopConnections(EventLoop *loop) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<LoopConnections> &item = loops_[loop];
+    if (!item) {
+        item = std::make_shared<LoopConnections>();
+        item->loop = loop;
+    }
+    return item.get();
+}
+
+void WebSocketServer::send(const TcpConnectionPtr &conn, std::string_view message, WebSocketCodec::Opcode opcode) {
+    if (conn->getLoop()->isInLoopThread()) {
+        sendInLoop(conn, opcode, message);
+    } else {
+        sendFrame(conn, makeFrame(message, opcode));
+    }
+}
+
+void WebSocketServer::send(const TcpConnectionPtr &conn, Buffer *buf, WebSocketCodec::Opcode opcode) {
+    WebSocketCodec::encode(buf, opcode);
+    conn->send(buf);
+}
+
+void WebSocketServer::close(const TcpConnectionPtr &conn, uint16_t code, std::string_view reason) {
+    conn->getLoop()->runInLoop([conn, code, reason = std::string(reason)] {
+        auto *session = std::any_cast<Session>(conn->getMutableContext());
+        if (session == nullptr || session->state != Open) {
+            return;
+        }
+        session->state = Closing;
+        sendClose(conn, code, reason);
+    });
+}
+
+WebSocketServer::Frame WebSocketServer::makeFrame(std::string_view message, WebSocketCodec::Opcode opcode) {
+    Buffer buf;
+    WebSocketCodec::appendFrame(&buf, opcode, message);
+    return std::make_shared<const std::string>(buf.peek(), buf.readableBytes());
+}
+
+void WebSocketServer::sendFrame(const TcpConnectionPtr &conn, const Frame &frame) {
+    if (conn->getLoop()->isInLoopThread()) {
+        conn->send(frame->data(), frame->size());
+    } else {
+        conn->getLoop()->queueInLoop([conn, frame] { conn->send(frame->data(), frame->size()); });
+    }
+}
+
+void WebSocketServer::broadcast(const Frame &frame) {
+    std::vector<std::shared_ptr<LoopConnections>> loops;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &item: loops_) {
+            loops.push_back(item.second);
+        }
+    }
+    for (auto &loop_connections: loops) {
+        loop_connections->loop->runInLoop([loop_connections, frame] {
+            for (auto &item: loop_connections->connections) {
+                item.second->send(frame->data(), frame->size());
+            }
+        });
+    }
+}
+
+size_t WebSocketServer::numOpenConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (auto &item: loops_) {
+        n += item.second->size.load(std::memory_order_relaxed);
+    }
+    return n;
+}